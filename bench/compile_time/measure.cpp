@@ -0,0 +1,44 @@
+// Runs a command, then reports the wall time and peak memory usage of the
+// command. This is used by the compile time benchmarks, which run it on the
+// compiler (see cmake/nav_compile_bench.cmake)
+#include <chrono>
+#include <cstdio>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <command> [args...]\n", argv[0]);
+        return 2;
+    }
+    auto start = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return 2;
+    }
+    if (pid == 0) {
+        execvp(argv[1], argv + 1);
+        perror(argv[1]);
+        _exit(127);
+    }
+
+    // The usage reported by wait4 includes any children of the command that
+    // it waited on, so this includes the compiler proper (eg, cc1plus)
+    int status = 0;
+    rusage usage {};
+    if (wait4(pid, &status, 0, &usage) < 0) {
+        perror("wait4");
+        return 2;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now()
+                                          - start;
+
+    // ru_maxrss is reported in kilobytes on Linux
+    printf(
+        "wall_seconds=%.3f peak_rss_kb=%ld\n",
+        elapsed.count(),
+        long(usage.ru_maxrss));
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
@@ -0,0 +1,63 @@
+#include <array>
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <nav/nav_counters.hpp>
+
+using benchmark::State;
+
+nav_declare_enum(
+    RequestType,
+    int,
+    Get = 1,
+    Head = 2,
+    Post = 4,
+    Put = 8,
+    Delete = 16,
+    Connect = 32,
+    Options = 64,
+    Trace = 128,
+    Patch = 256);
+
+// Each thread counts requests of every type in turn, so threads write to the
+// same counters at the same time
+constexpr size_t num_types = nav::num_states<RequestType>;
+
+// The baseline: one atomic counter per value, shared by every thread
+std::array<std::atomic<int64_t>, num_types> shared_counts {};
+
+void count_shared_atomics(State& state) {
+    size_t i = size_t(state.thread_index());
+    for (auto _ : state) {
+        RequestType type = nav::enum_values<RequestType>[i % num_types];
+        shared_counts[nav::ordinal_of(type)].fetch_add(
+            1,
+            std::memory_order_relaxed);
+        i++;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+nav::enum_counters<RequestType> sharded_counts;
+
+void count_enum_counters(State& state) {
+    size_t i = size_t(state.thread_index());
+    for (auto _ : state) {
+        sharded_counts.add(nav::enum_values<RequestType>[i % num_types]);
+        i++;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Writes the counts as text, as when exporting metrics
+void write_enum_counters(State& state) {
+    char buffer[nav::enum_counters<RequestType>::max_output_size];
+    for (auto _ : state) {
+        auto result = sharded_counts.write_to(buffer, buffer + sizeof(buffer));
+        benchmark::DoNotOptimize(result.ptr);
+        benchmark::ClobberMemory();
+    }
+}
+
+BENCHMARK(count_shared_atomics)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(count_enum_counters)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(write_enum_counters);
@@ -1,56 +1,103 @@
 #include <benchmark/benchmark.h>
 #include <nav/nav_hashmap.hpp>
+#include <random>
+#include <string>
 #include <utility>
+#include <vector>
 
 using benchmark::State;
 
-template <class Fn>
-void hash_string(State& state, Fn func, std::string_view sv) {
+struct nav_hash {
+    uint64_t operator()(std::string_view sv) const noexcept {
+        return nav::detail::block8_hash_seeded(sv, 0);
+    }
+};
+
+struct nav_hash_ignore_case {
+    uint64_t operator()(std::string_view sv) const noexcept {
+        return nav::detail::block8_hash_ignore_case_seeded(sv, 0);
+    }
+};
+
+using std_hash = std::hash<std::string_view>;
+
+// Number of distinct strings hashed by the random benchmarks. They fit in L1
+// for short lengths, so the benchmarks measure the hash rather than the cache
+constexpr size_t num_random_inputs = 256;
+
+// Makes count strings of the given size, filled with random bytes
+inline std::vector<std::string> make_inputs(size_t size, size_t count) {
+    auto rng = std::mt19937_64 {1};
+    std::vector<std::string> inputs;
+    for (size_t i = 0; i < count; i++) {
+        std::string str(size, '\0');
+        for (char& ch : str) {
+            ch = char(rng());
+        }
+        inputs.push_back(std::move(str));
+    }
+    return inputs;
+}
+
+/**
+ * @brief Hashes strings of length state.range(0).
+ *
+ * With Random, the strings cycle through num_random_inputs different random
+ * strings, so the branches taken on the contents of the string can't be
+ * learned. Otherwise the same string is hashed every time.
+ *
+ * With Latency, the address of each string depends on the hash of the string
+ * before it (it's offset by the hash ANDed with an opaque zero), so hashes
+ * can't overlap, and the benchmark measures the time from the string to its
+ * hash. Otherwise, hashes are independent, and the benchmark measures how many
+ * the CPU can compute at once.
+ */
+template <class Hash, bool Random, bool Latency>
+void hash_string(State& state) {
+    size_t size = size_t(state.range(0));
+    auto inputs = make_inputs(size, Random ? num_random_inputs : 1);
+    auto views = std::vector<std::string_view>(inputs.begin(), inputs.end());
+    uint64_t zero = 0;
+    benchmark::DoNotOptimize(zero);
+
+    Hash hash {};
+    uint64_t h = 0;
+    size_t i = 0;
     for (auto _ : state) {
-        benchmark::DoNotOptimize(sv);
-        auto result = func(sv);
-        benchmark::DoNotOptimize(result);
+        std::string_view sv = views[i];
+        if constexpr (Latency) {
+            sv = std::string_view(sv.data() + (h & zero), sv.size());
+        } else {
+            benchmark::DoNotOptimize(sv);
+        }
+        h = hash(sv);
+        benchmark::DoNotOptimize(h);
+        i = i + 1 == views.size() ? 0 : i + 1;
     }
+    state.SetBytesProcessed(int64_t(state.iterations() * size));
 }
 
-using nav::detail::hash_sv;
-constexpr auto std_hash_sv = std::hash<std::string_view> {};
-
-constexpr std::string_view source = "0123456789abcdef0123456789abcdef";
-
-BENCHMARK_CAPTURE(hash_string, (hash, 0), hash_sv, source.substr(0, 0));
-BENCHMARK_CAPTURE(hash_string, (hash, 1), hash_sv, source.substr(0, 1));
-BENCHMARK_CAPTURE(hash_string, (hash, 2), hash_sv, source.substr(0, 2));
-BENCHMARK_CAPTURE(hash_string, (hash, 3), hash_sv, source.substr(0, 3));
-BENCHMARK_CAPTURE(hash_string, (hash, 4), hash_sv, source.substr(0, 4));
-BENCHMARK_CAPTURE(hash_string, (hash, 5), hash_sv, source.substr(0, 5));
-BENCHMARK_CAPTURE(hash_string, (hash, 6), hash_sv, source.substr(0, 6));
-BENCHMARK_CAPTURE(hash_string, (hash, 7), hash_sv, source.substr(0, 7));
-BENCHMARK_CAPTURE(hash_string, (hash, 8), hash_sv, source.substr(0, 8));
-BENCHMARK_CAPTURE(hash_string, (hash, 9), hash_sv, source.substr(0, 9));
-BENCHMARK_CAPTURE(hash_string, (hash, 10), hash_sv, source.substr(0, 10));
-BENCHMARK_CAPTURE(hash_string, (hash, 11), hash_sv, source.substr(0, 11));
-BENCHMARK_CAPTURE(hash_string, (hash, 12), hash_sv, source.substr(0, 12));
-BENCHMARK_CAPTURE(hash_string, (hash, 13), hash_sv, source.substr(0, 13));
-BENCHMARK_CAPTURE(hash_string, (hash, 14), hash_sv, source.substr(0, 14));
-BENCHMARK_CAPTURE(hash_string, (hash, 15), hash_sv, source.substr(0, 15));
-BENCHMARK_CAPTURE(hash_string, (hash, 16), hash_sv, source.substr(0, 16));
-
-
-BENCHMARK_CAPTURE(hash_string, (std_hash, 0), std_hash_sv, source.substr(0, 0));
-BENCHMARK_CAPTURE(hash_string, (std_hash, 1), std_hash_sv, source.substr(0, 1));
-BENCHMARK_CAPTURE(hash_string, (std_hash, 2), std_hash_sv, source.substr(0, 2));
-BENCHMARK_CAPTURE(hash_string, (std_hash, 3), std_hash_sv, source.substr(0, 3));
-BENCHMARK_CAPTURE(hash_string, (std_hash, 4), std_hash_sv, source.substr(0, 4));
-BENCHMARK_CAPTURE(hash_string, (std_hash, 5), std_hash_sv, source.substr(0, 5));
-BENCHMARK_CAPTURE(hash_string, (std_hash, 6), std_hash_sv, source.substr(0, 6));
-BENCHMARK_CAPTURE(hash_string, (std_hash, 7), std_hash_sv, source.substr(0, 7));
-BENCHMARK_CAPTURE(hash_string, (std_hash, 8), std_hash_sv, source.substr(0, 8));
-BENCHMARK_CAPTURE(hash_string, (std_hash, 9), std_hash_sv, source.substr(0, 9));
-BENCHMARK_CAPTURE(hash_string, (std_hash, 10), std_hash_sv, source.substr(0, 10));
-BENCHMARK_CAPTURE(hash_string, (std_hash, 11), std_hash_sv, source.substr(0, 11));
-BENCHMARK_CAPTURE(hash_string, (std_hash, 12), std_hash_sv, source.substr(0, 12));
-BENCHMARK_CAPTURE(hash_string, (std_hash, 13), std_hash_sv, source.substr(0, 13));
-BENCHMARK_CAPTURE(hash_string, (std_hash, 14), std_hash_sv, source.substr(0, 14));
-BENCHMARK_CAPTURE(hash_string, (std_hash, 15), std_hash_sv, source.substr(0, 15));
-BENCHMARK_CAPTURE(hash_string, (std_hash, 16), std_hash_sv, source.substr(0, 16));
+// Every length up to 16, and then longer names up to 256 bytes
+#define NAV_BENCH_HASH(hash, input, mode, Random, Latency)                     \
+    BENCHMARK_TEMPLATE(hash_string, hash, Random, Latency)                     \
+        ->Name("hash_string/" #hash "/" #input "/" #mode)                      \
+        ->ArgName("length")                                                    \
+        ->DenseRange(0, 16)                                                    \
+        ->Arg(24)                                                              \
+        ->Arg(32)                                                              \
+        ->Arg(48)                                                              \
+        ->Arg(64)                                                              \
+        ->Arg(96)                                                              \
+        ->Arg(128)                                                             \
+        ->Arg(192)                                                             \
+        ->Arg(256);
+
+#define NAV_BENCH_HASH_MODES(hash)                                             \
+    NAV_BENCH_HASH(hash, fixed, latency, false, true)                          \
+    NAV_BENCH_HASH(hash, fixed, throughput, false, false)                      \
+    NAV_BENCH_HASH(hash, random, latency, true, true)                          \
+    NAV_BENCH_HASH(hash, random, throughput, true, false)
+
+NAV_BENCH_HASH_MODES(nav_hash)
+NAV_BENCH_HASH_MODES(nav_hash_ignore_case)
+NAV_BENCH_HASH_MODES(std_hash)
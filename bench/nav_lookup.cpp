@@ -0,0 +1,354 @@
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <nav/core.hpp>
+#include <nav/nav_batch.hpp>
+#include <nav/nav_charconv.hpp>
+#include <nav/nav_fuzzy_match.hpp>
+#include <nav/nav_libfmt.hpp>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+// Generated by CMake. Defines NAV_BENCH_ENUMS(X), which calls
+// X(kind, names, size) for each generated enum, and includes the headers
+// defining their values. See nav_generate_enum_header for the meaning of each
+// parameter
+#include <nav_bench_enums.hpp>
+
+using benchmark::State;
+
+#define NAV_BENCH_DECLARE_ENUM(kind, names, size)                              \
+    nav_declare_enum(                                                          \
+        kind##_##names##_##size,                                               \
+        int,                                                                   \
+        NAV_BENCH_##kind##_##names##_##size##_TEST_VALUES);
+
+NAV_BENCH_ENUMS(NAV_BENCH_DECLARE_ENUM)
+
+// Number of queries to cycle through. This is at least as large as the enum,
+// so that large enums are benchmarked with a cold cache
+template <class Enum>
+constexpr size_t num_queries = std::max<size_t>(1024, nav::num_states<Enum>);
+
+// Returns the indices of the queries that should miss. miss_percent% of the
+// queries are misses, spread randomly through the list
+inline std::vector<bool> choose_misses(size_t count, int64_t miss_percent) {
+    std::vector<bool> is_miss(count);
+    for (size_t i = 0; i < count; i++) {
+        is_miss[i] = int64_t(i % 100) < miss_percent;
+    }
+    std::shuffle(is_miss.begin(), is_miss.end(), std::mt19937_64 {});
+    return is_miss;
+}
+
+// Names to look up. A miss is a name with the last character replaced, so
+// that it has the same length (and mostly the same contents) as a real name
+template <class Enum>
+std::vector<std::string> name_queries(int64_t miss_percent) {
+    using traits = nav::enum_traits<Enum>;
+    auto is_miss = choose_misses(num_queries<Enum>, miss_percent);
+    auto rng = std::mt19937_64 {1};
+    std::vector<std::string> queries;
+    for (bool miss : is_miss) {
+        std::string name(traits::names[rng() % traits::size]);
+        if (miss) {
+            name.back() = '#';
+        }
+        queries.push_back(std::move(name));
+    }
+    return queries;
+}
+
+// Values to look up. A miss is the first value after a real value that isn't
+// in the enum
+template <class Enum>
+std::vector<Enum> value_queries(int64_t miss_percent) {
+    using traits = nav::enum_traits<Enum>;
+    auto is_miss = choose_misses(num_queries<Enum>, miss_percent);
+    auto rng = std::mt19937_64 {1};
+    std::vector<Enum> queries;
+    for (bool miss : is_miss) {
+        Enum value = traits::values[rng() % traits::size];
+        if (miss) {
+            do {
+                value = Enum(int(value) + 1);
+            } while (traits::get_name(value));
+        }
+        queries.push_back(value);
+    }
+    return queries;
+}
+
+template <class Queries, class Fn>
+void run_queries(State& state, Queries const& queries, Fn lookup) {
+    size_t i = 0;
+    for (auto _ : state) {
+        auto const& query = queries[i];
+        benchmark::DoNotOptimize(query);
+        auto result = lookup(query);
+        benchmark::DoNotOptimize(result);
+        i = i + 1 == queries.size() ? 0 : i + 1;
+    }
+}
+
+template <class Enum>
+void get_name(State& state) {
+    run_queries(state, value_queries<Enum>(state.range(0)), [](Enum value) {
+        return nav::enum_traits<Enum>::get_name(value);
+    });
+}
+
+// Finds the name with a binary search over the sorted values, as get_name did
+// for sparse enums before value_index. This is the baseline for get_name
+template <class Enum>
+void get_name_binary_search(State& state) {
+    using traits = nav::enum_traits<Enum>;
+    std::vector<std::pair<Enum, std::string_view>> sorted;
+    for (size_t i = 0; i < traits::size; i++) {
+        sorted.emplace_back(traits::values[i], traits::names[i]);
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](auto& a, auto& b) {
+        return a.first < b.first;
+    });
+    run_queries(
+        state,
+        value_queries<Enum>(state.range(0)),
+        [&](Enum value) -> std::optional<std::string_view> {
+            auto it = std::lower_bound(
+                sorted.begin(),
+                sorted.end(),
+                value,
+                [](auto& entry, Enum key) { return entry.first < key; });
+            if (it != sorted.end() && it->first == value) {
+                return it->second;
+            }
+            return std::nullopt;
+        });
+}
+
+template <class Enum>
+void get_value(State& state) {
+    run_queries(
+        state,
+        name_queries<Enum>(state.range(0)),
+        [](std::string const& name) {
+            return nav::enum_traits<Enum>::get_value(name);
+        });
+}
+
+// Queries are converted to uppercase, so that case folding is measured
+template <class Enum>
+void get_value_ignore_case(State& state) {
+    auto queries = name_queries<Enum>(state.range(0));
+    for (auto& name : queries) {
+        for (char& c : name) {
+            c = 'a' <= c && c <= 'z' ? c - 'a' + 'A' : c;
+        }
+    }
+    run_queries(state, queries, [](std::string const& name) {
+        return nav::enum_traits<Enum>::get_value_ignore_case(name);
+    });
+}
+
+template <class Enum>
+void fuzzy_match_enum(State& state) {
+    run_queries(
+        state,
+        name_queries<Enum>(state.range(0)),
+        [](std::string const& name) {
+            return nav::fuzzy_match_enum<Enum>(name);
+        });
+}
+
+// Up to 5 suggestions within a distance of 2, as when reporting an unknown name
+template <class Enum>
+void fuzzy_match_enum_top(State& state) {
+    run_queries(
+        state,
+        name_queries<Enum>(state.range(0)),
+        [](std::string const& name) {
+            return nav::fuzzy_match_enum_top<Enum, 5>(name, 2);
+        });
+}
+
+template <class Enum>
+void from_chars(State& state) {
+    run_queries(
+        state,
+        name_queries<Enum>(state.range(0)),
+        [](std::string const& name) {
+            Enum value {};
+            auto result = nav::from_chars(
+                name.data(),
+                name.data() + name.size(),
+                value);
+            return std::pair(result.ptr, value);
+        });
+}
+
+template <class Enum>
+void to_chars(State& state) {
+    run_queries(state, value_queries<Enum>(state.range(0)), [](Enum value) {
+        char buffer[64];
+        auto result = nav::to_chars(buffer, buffer + sizeof(buffer), value);
+        benchmark::DoNotOptimize(buffer);
+        return result.ptr - buffer;
+    });
+}
+
+// Formats a value with its type attached, as structured logging does
+template <class Enum>
+void format_qualified(State& state) {
+    fmt::memory_buffer buffer;
+    run_queries(state, value_queries<Enum>(state.range(0)), [&](Enum value) {
+        buffer.clear();
+        fmt::format_to(std::back_inserter(buffer), "{:Q}", value);
+        return buffer.size();
+    });
+}
+
+// Parses a whole column of names per iteration, one get_value call at a time.
+// This is the baseline for parse_names
+template <class Enum>
+void get_value_column(State& state) {
+    auto queries = name_queries<Enum>(state.range(0));
+    auto names = std::vector<std::string_view>(queries.begin(), queries.end());
+    auto values = std::vector<Enum>(names.size());
+    auto valid = std::vector<uint64_t>(nav::bitmap_words(names.size()));
+    for (auto _ : state) {
+        for (size_t i = 0; i < names.size(); i++) {
+            auto value = nav::enum_traits<Enum>::get_value(names[i]);
+            values[i] = value ? *value : Enum();
+            valid[i / 64] |= uint64_t(bool(value)) << (i % 64);
+        }
+        benchmark::DoNotOptimize(values.data());
+        benchmark::DoNotOptimize(valid.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * names.size());
+}
+
+template <class Enum>
+void parse_names(State& state) {
+    auto queries = name_queries<Enum>(state.range(0));
+    auto names = std::vector<std::string_view>(queries.begin(), queries.end());
+    auto values = std::vector<Enum>(names.size());
+    auto valid = std::vector<uint64_t>(nav::bitmap_words(names.size()));
+    for (auto _ : state) {
+        size_t num_found = nav::parse_names<Enum>(
+            nav::view {names.data(), names.size()},
+            values.data(),
+            valid.data());
+        benchmark::DoNotOptimize(num_found);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * names.size());
+}
+
+// Joins the names of a whole column of values per iteration, one get_name call
+// at a time. This is the baseline for write_names
+template <class Enum>
+void join_names(State& state) {
+    auto values = value_queries<Enum>(state.range(0));
+    std::string result;
+    for (auto _ : state) {
+        result.clear();
+        for (size_t i = 0; i < values.size(); i++) {
+            if (i > 0) {
+                result += ',';
+            }
+            result += nav::enum_traits<Enum>::get_name(values[i], "<unnamed>");
+        }
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+template <class Enum>
+void write_names(State& state) {
+    auto values = value_queries<Enum>(state.range(0));
+    auto view = nav::view<Enum> {values.data(), values.size()};
+    std::string result;
+    for (auto _ : state) {
+        result.resize(nav::names_size(view, ",", "<unnamed>"));
+        char* end = nav::write_names(
+            view,
+            result.data(),
+            result.size(),
+            ",",
+            "<unnamed>");
+        benchmark::DoNotOptimize(end);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+// Walks the names and values of the whole enum per iteration, reading the
+// first character of each name. This reads enum_names and enum_values side by
+// side, and is the baseline for iterate_entries. The tables are passed through
+// DoNotOptimize so that the sum can't be computed at compile time
+template <class Enum>
+void zip_names_values(State& state) {
+    for (auto _ : state) {
+        auto const* block = &nav::enum_names<Enum>.get_name_block();
+        auto const* values = nav::enum_values<Enum>.begin();
+        benchmark::DoNotOptimize(block);
+        benchmark::DoNotOptimize(values);
+        size_t total = 0;
+        for (size_t i = 0; i < nav::num_states<Enum>; i++) {
+            std::string_view name = (*block)[i];
+            total += name.size() + name[0] + size_t(values[i]);
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * nav::num_states<Enum>);
+}
+
+template <class Enum>
+void iterate_entries(State& state) {
+    for (auto _ : state) {
+        auto it = nav::enum_entries<Enum>.begin();
+        benchmark::DoNotOptimize(it);
+        size_t total = 0;
+        for (size_t i = 0; i < nav::num_states<Enum>; i++, ++it) {
+            auto [name, value] = *it;
+            total += name.size() + name[0] + size_t(value);
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * nav::num_states<Enum>);
+}
+
+#define NAV_BENCH_REGISTER(func, kind, names, size)                            \
+    BENCHMARK_TEMPLATE(func, kind##_##names##_##size)                          \
+        ->Name(#func "/" #kind "/" #names "/" #size)                           \
+        ->ArgName("miss_percent")                                              \
+        ->Arg(0)                                                               \
+        ->Arg(50)                                                              \
+        ->Arg(100);
+
+// Registers a benchmark that walks the whole enum, so there are no misses
+#define NAV_BENCH_REGISTER_WALK(func, kind, names, size)                       \
+    BENCHMARK_TEMPLATE(func, kind##_##names##_##size)                          \
+        ->Name(#func "/" #kind "/" #names "/" #size);
+
+#define NAV_BENCH_LOOKUP(kind, names, size)                                    \
+    NAV_BENCH_REGISTER(get_name, kind, names, size)                            \
+    NAV_BENCH_REGISTER(get_name_binary_search, kind, names, size)              \
+    NAV_BENCH_REGISTER(get_value, kind, names, size)                           \
+    NAV_BENCH_REGISTER(get_value_ignore_case, kind, names, size)               \
+    NAV_BENCH_REGISTER(fuzzy_match_enum, kind, names, size)                    \
+    NAV_BENCH_REGISTER(fuzzy_match_enum_top, kind, names, size)                \
+    NAV_BENCH_REGISTER(from_chars, kind, names, size)                          \
+    NAV_BENCH_REGISTER(to_chars, kind, names, size)                            \
+    NAV_BENCH_REGISTER(format_qualified, kind, names, size)                    \
+    NAV_BENCH_REGISTER(get_value_column, kind, names, size)                    \
+    NAV_BENCH_REGISTER(parse_names, kind, names, size)                         \
+    NAV_BENCH_REGISTER(join_names, kind, names, size)                          \
+    NAV_BENCH_REGISTER(write_names, kind, names, size)                         \
+    NAV_BENCH_REGISTER_WALK(zip_names_values, kind, names, size)               \
+    NAV_BENCH_REGISTER_WALK(iterate_entries, kind, names, size)
+
+NAV_BENCH_ENUMS(NAV_BENCH_LOOKUP)
@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <nav/core.hpp>
+#include <random>
+#include <vector>
+
+using benchmark::State;
+
+// Generates N distinct names at compile time, with lengths between 4 and 19
+// characters. Each name ends with the index written in base 26, so names are
+// unique.
+template <size_t N>
+struct generated_names {
+    char data[N * 24] {};
+    std::array<std::string_view, N> names {};
+    std::array<int, N> values {};
+
+    constexpr generated_names() {
+        uint64_t state = 0x853c49e6748fea9b;
+        size_t offset = 0;
+        for (size_t i = 0; i < N; i++) {
+            state = state * 6364136223846793005 + 1442695040888963407;
+            size_t prefix_length = 3 + (state >> 60);
+            char* name = data + offset;
+            size_t length = 0;
+            for (size_t j = 0; j < prefix_length; j++) {
+                name[length++] = char('a' + (state >> (j * 3 % 56)) % 26);
+            }
+            size_t index = i;
+            do {
+                name[length++] = char('A' + index % 26);
+                index /= 26;
+            } while (index > 0);
+            names[i] = std::string_view(name, length);
+            values[i] = int(i);
+            offset += length;
+        }
+    }
+};
+
+template <size_t N>
+constexpr generated_names<N> names_v {};
+
+template <size_t N>
+constexpr auto binary_map_v = nav::detail::binary_map<std::string_view, int, N>(
+    names_v<N>.names,
+    names_v<N>.values);
+
+template <size_t N>
+constexpr auto perfect_hash_map_v = nav::detail::perfect_hash_map<int, N>(
+    names_v<N>.names,
+    names_v<N>.values);
+
+// Names to look up, in random order
+template <size_t N>
+std::vector<std::string_view> shuffled_names() {
+    auto names = std::vector<std::string_view>(
+        names_v<N>.names.begin(),
+        names_v<N>.names.end());
+    std::shuffle(names.begin(), names.end(), std::mt19937_64 {});
+    return names;
+}
+
+template <size_t N, auto const& Map>
+void lookup_name(State& state) {
+    auto names = shuffled_names<N>();
+    size_t i = 0;
+    for (auto _ : state) {
+        std::string_view name = names[i];
+        benchmark::DoNotOptimize(name);
+        auto result = Map[name];
+        benchmark::DoNotOptimize(result);
+        i = i + 1 == names.size() ? 0 : i + 1;
+    }
+}
+
+#define NAV_BENCH_NAME_LOOKUP(N)                                               \
+    BENCHMARK_TEMPLATE(lookup_name, N, binary_map_v<N>)                        \
+        ->Name("binary_map/" #N);                                              \
+    BENCHMARK_TEMPLATE(lookup_name, N, perfect_hash_map_v<N>)                  \
+        ->Name("perfect_hash_map/" #N)
+
+NAV_BENCH_NAME_LOOKUP(4);
+NAV_BENCH_NAME_LOOKUP(8);
+NAV_BENCH_NAME_LOOKUP(16);
+NAV_BENCH_NAME_LOOKUP(32);
+NAV_BENCH_NAME_LOOKUP(64);
+NAV_BENCH_NAME_LOOKUP(256);
+NAV_BENCH_NAME_LOOKUP(1024);
+NAV_BENCH_NAME_LOOKUP(4096);
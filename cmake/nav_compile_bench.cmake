@@ -0,0 +1,123 @@
+# Measures the cost of compiling enums declared with NAV_DECLARE_ENUM. This
+# script is run in script mode by the nav_compile_bench target:
+#
+#   cmake --build build --target nav_compile_bench
+#
+# For every compiler, enum kind (dense or sparse) and enum size, it compiles
+# each program in test_code/ with a generated header supplying TEST_VALUES, and
+# records the wall time, peak memory usage, and size of the resulting object
+# file. Results are written to ${NAV_WORK_DIR}/compile_bench.csv
+#
+# Variables (pass with -D):
+#   NAV_SOURCE_DIR   the root of the nav repository
+#   NAV_WORK_DIR     directory for generated headers, objects and results
+#   NAV_MEASURE      path to the nav_measure executable
+#   NAV_COMPILERS    comma separated list of C++ compilers
+#   NAV_SIZES        comma separated list of enum sizes
+#   NAV_PROGRAMS     comma separated list of programs in test_code/
+#   NAV_CXX_FLAGS    comma separated list of flags passed to each compiler
+
+include("${CMAKE_CURRENT_LIST_DIR}/nav_generate_enum.cmake")
+
+foreach(
+    var
+    NAV_SOURCE_DIR
+    NAV_WORK_DIR
+    NAV_MEASURE
+    NAV_COMPILERS
+    NAV_SIZES
+    NAV_PROGRAMS)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "nav_compile_bench: ${var} must be defined")
+    endif()
+endforeach()
+
+string(
+    REPLACE ","
+            ";"
+            compilers
+            "${NAV_COMPILERS}")
+string(
+    REPLACE ","
+            ";"
+            sizes
+            "${NAV_SIZES}")
+string(
+    REPLACE ","
+            ";"
+            programs
+            "${NAV_PROGRAMS}")
+string(
+    REPLACE ","
+            ";"
+            cxx_flags
+            "${NAV_CXX_FLAGS}")
+
+file(MAKE_DIRECTORY "${NAV_WORK_DIR}")
+set(csv "compiler,program,kind,size,status,wall_seconds,peak_rss_kb,object_bytes\n")
+
+foreach(kind dense sparse)
+    foreach(size ${sizes})
+        nav_generate_enum_header("${NAV_WORK_DIR}/${kind}_${size}.hpp" ${size}
+                                 ${kind})
+    endforeach()
+endforeach()
+
+foreach(compiler ${compilers})
+    get_filename_component(
+        compiler_name
+        "${compiler}"
+        NAME)
+    foreach(program ${programs})
+        foreach(kind dense sparse)
+            foreach(size ${sizes})
+                set(header "${NAV_WORK_DIR}/${kind}_${size}.hpp")
+                set(object
+                    "${NAV_WORK_DIR}/${compiler_name}_${program}_${kind}_${size}.o")
+                file(REMOVE "${object}")
+
+                execute_process(
+                    COMMAND
+                        "${NAV_MEASURE}" "${compiler}" ${cxx_flags}
+                        "-I${NAV_SOURCE_DIR}/include" -include "${header}" -c
+                        "${NAV_SOURCE_DIR}/test_code/${program}.cpp" -o
+                        "${object}"
+                    RESULT_VARIABLE result
+                    OUTPUT_VARIABLE measurement
+                    ERROR_VARIABLE errors)
+
+                string(
+                    REGEX MATCH
+                          "wall_seconds=([0-9.]+) peak_rss_kb=([0-9]+)"
+                          _
+                          "${measurement}")
+                set(wall_seconds "${CMAKE_MATCH_1}")
+                set(peak_rss_kb "${CMAKE_MATCH_2}")
+
+                if(result EQUAL 0 AND EXISTS "${object}")
+                    set(status "ok")
+                    file(SIZE "${object}" object_bytes)
+                else()
+                    set(status "failed")
+                    set(object_bytes "")
+                    file(WRITE
+                         "${NAV_WORK_DIR}/${compiler_name}_${program}_${kind}_${size}.log"
+                         "${errors}")
+                endif()
+
+                string(
+                    APPEND
+                    csv
+                    "${compiler_name},${program},${kind},${size},${status},"
+                    "${wall_seconds},${peak_rss_kb},${object_bytes}\n")
+                set(line
+                    "${compiler_name} ${program} ${kind} ${size}: ${status}, ${wall_seconds}s, ${peak_rss_kb} KB peak RSS, ${object_bytes} byte object"
+                )
+                message(STATUS "${line}")
+            endforeach()
+        endforeach()
+    endforeach()
+endforeach()
+
+file(WRITE "${NAV_WORK_DIR}/compile_bench.csv" "${csv}")
+message(STATUS "Results written to ${NAV_WORK_DIR}/compile_bench.csv")
@@ -0,0 +1,108 @@
+# nav_generate_enum_header writes a header that defines NUM_VALUES and
+# TEST_VALUES, which are the inputs to the programs in test_code/. The enum has
+# ${count} members.
+#
+#   nav_generate_enum_header(path count kind [PREFIX prefix] [NAMES names])
+#
+# kind is one of:
+#   dense:  E0, E1, E2, ... (values are 0, 1, 2, ...)
+#   sparse: E0 = 1, E1 = E0 + 920, E2 = E1 + 839, ... Each member is defined in
+#           terms of the previous member, like the enum in
+#           tests/sparse_enums.cpp, and the gaps between values are large
+#           enough that the enum isn't compact
+#   clustered: like sparse, but members come in clusters of 50, where each
+#           value is 1 or 2 more than the one before it, and the clusters are
+#           1000 to 2000 apart (like status codes, which are grouped by
+#           category)
+#
+# PREFIX is prepended to the names of both macros, so that several generated
+# headers can be included in the same file (default: no prefix)
+#
+# NAMES controls the length of the names of the members:
+#   short: E0, E1, E2, ... (the default)
+#   long:  a common 32 character prefix, followed by the index
+#   mixed: names between 2 and 40 characters long, with different lengths
+#          spread evenly through the enum
+function(
+    nav_generate_enum_header
+    path
+    count
+    kind)
+    cmake_parse_arguments(
+        PARSE_ARGV
+        3
+        ARG
+        ""
+        "PREFIX;NAMES"
+        "")
+    if(NOT ARG_NAMES)
+        set(ARG_NAMES short)
+    endif()
+    if(NOT
+       kind
+       MATCHES
+       "^(dense|sparse|clustered)$")
+        message(FATAL_ERROR "nav_generate_enum_header: unknown kind '${kind}'")
+    endif()
+    if(NOT
+       ARG_NAMES
+       MATCHES
+       "^(short|long|mixed)$")
+        message(
+            FATAL_ERROR "nav_generate_enum_header: unknown names '${ARG_NAMES}'")
+    endif()
+    set(filler "AbcdefghijklmnopqrstuvwxyzAbcdefghijk")
+
+    set(content
+        "// Generated by nav_generate_enum_header (${kind}, ${ARG_NAMES}, ${count})\n"
+    )
+    string(APPEND content "#define ${ARG_PREFIX}NUM_VALUES ${count}\n")
+    string(APPEND content "#define ${ARG_PREFIX}TEST_VALUES")
+
+    math(EXPR last "${count} - 1")
+    foreach(i RANGE 0 ${last})
+        if(ARG_NAMES STREQUAL "long")
+            string(SUBSTRING "${filler}" 0 32 name)
+            string(APPEND name "${i}")
+        elseif(ARG_NAMES STREQUAL "mixed")
+            math(EXPR length "(${i} * 37) % 36")
+            string(SUBSTRING "${filler}" 0 ${length} name)
+            set(name "E${name}${i}")
+        else()
+            set(name "E${i}")
+        endif()
+
+        if(i EQUAL 0)
+            set(sep " \\\n")
+        else()
+            set(sep ", \\\n")
+        endif()
+        if(kind STREQUAL "dense")
+            string(APPEND content "${sep}    ${name}")
+        elseif(i EQUAL 0)
+            string(APPEND content "${sep}    ${name} = 1")
+        elseif(kind STREQUAL "clustered")
+            math(EXPR cluster_index "${i} % 50")
+            if(cluster_index EQUAL 0)
+                math(EXPR gap "1000 + (${i} * 7919) % 1000")
+            else()
+                math(EXPR gap "1 + (${i} * 7919) % 3 / 2")
+            endif()
+            string(APPEND content "${sep}    ${name} = ${prev_name} + ${gap}")
+        else()
+            math(EXPR gap "1 + (${i} * 7919) % 1000")
+            string(APPEND content "${sep}    ${name} = ${prev_name} + ${gap}")
+        endif()
+        set(prev_name "${name}")
+    endforeach()
+    string(APPEND content "\n")
+
+    # Only write the file if it changed, to avoid triggering rebuilds
+    if(EXISTS "${path}")
+        file(READ "${path}" old_content)
+        if(old_content STREQUAL content)
+            return()
+        endif()
+    endif()
+    file(WRITE "${path}" "${content}")
+endfunction()
@@ -1,7 +1,12 @@
 #pragma once
 #include <optional>
 #include <array>
+#include <cstdint>
 #include <string_view>
+#include <type_traits>
+
+#include <nav/nav_core.hpp>
+#include <nav/nav_hashmap.hpp>
 
 namespace nav {
 // Small convinient view class
@@ -74,6 +79,20 @@ constexpr T max_elem(T const* ptr) {
         return max;
     }
 }
+/**
+ * @brief Compute the smallest number of the form 2^N-1 such that 2^N-1 >= i
+ *
+ * @param i
+ * @return constexpr size_t
+ */
+constexpr size_t bit_ceil_minus_1(size_t i) {
+    size_t ceil = 0;
+    while (ceil < i) {
+        ceil <<= 1;
+        ceil |= 1;
+    }
+    return ceil;
+}
 template <class T>
 constexpr auto compare(T const& a, T const& b) {
 #if __cpp_impl_three_way_comparison >= 201907L
@@ -102,15 +121,15 @@ constexpr auto compare(map_entry<K, V> const& a, map_entry<K, V> const& b) {
 template <class T, class K>
 constexpr auto binary_search(view<T> vals, K key) -> T const* {
     size_t lower_i = 0;
-    size_t upper_i = vals.size() - 1;
-    while (lower_i <= upper_i) {
+    size_t upper_i = vals.size();
+    while (lower_i < upper_i) {
         size_t i = (lower_i + upper_i) / 2;
         auto cmp = compare(vals[i], key);
 
         if (cmp < 0) {
             lower_i = i + 1;
         } else if (cmp > 0) {
-            upper_i = i - 1;
+            upper_i = i;
         } else {
             return &vals[i];
         }
@@ -123,43 +142,51 @@ constexpr void swap(T& a, T& b) {
     a = static_cast<T&&>(b);
     b = static_cast<T&&>(Tmp);
 }
-constexpr auto to_lower = [](char ch) -> char {
-    return 'A' <= ch && ch <= 'Z' ? ch - 'A' + 'a' : ch;
-};
-template <class Key, class Value, class BaseT, BaseT Min, BaseT Max>
+/**
+ * @brief Maps keys in the range [Min, Max] to values by indexing a table.
+ *
+ * Each slot of the table holds the ordinal of its value, in the smallest type
+ * that fits, and a bitset marks which slots are present. The values aren't
+ * copied, so they must outlive the map (enum_traits passes its own static
+ * arrays). If every slot in the range is present, lookups skip the bitset, so
+ * a lookup is a subtraction, a bounds check, and two loads. If a key appears
+ * more than once, the first value is kept.
+ */
+template <class Key, class Value, size_t N, class BaseT, BaseT Min, BaseT Max>
 class indexed_map {
     constexpr static size_t ArraySize = Max - Min + 1;
-    std::array<Value, ArraySize> vals {};
-    std::array<bool, ArraySize> present {};
+    using ordinal_type = uint_fit_t<N>;
+    Value const* vals = nullptr;
+    std::array<ordinal_type, ArraySize> ordinals {};
+    std::array<uint64_t, (ArraySize + 63) / 64> present {};
+    bool is_contiguous = false;
 
-    Value default_value;
+    constexpr bool has_slot(size_t slot) const noexcept {
+        return (present[slot / 64] >> (slot % 64)) & 1;
+    }
 
    public:
-    template <size_t N>
     constexpr indexed_map(
         std::array<Key, N> const& keys,
-        std::array<Value, N> const& values,
-        Value default_value)
-      : vals()
-      , present()
-      , default_value(default_value) {
-        for (auto& val : vals) {
-            val = default_value;
-        }
+        std::array<Value, N> const& values)
+      : vals(values.data()) {
+        size_t count = 0;
         for (size_t i = 0; i < N; i++) {
-            auto key_i = BaseT(keys[i]) - Min;
-            if (!present[key_i]) {
-                vals[key_i] = values[i];
-                present[key_i] = true;
+            size_t slot = size_t(BaseT(keys[i]) - Min);
+            if (!has_slot(slot)) {
+                present[slot / 64] |= uint64_t(1) << (slot % 64);
+                ordinals[slot] = ordinal_type(i);
+                count++;
             }
         }
+        is_contiguous = count == ArraySize;
     }
     constexpr auto contains(Key key) const -> bool {
         auto i = BaseT(key);
         if (i < Min || i > Max) {
             return false;
         } else {
-            return present[i - Min];
+            return is_contiguous || has_slot(size_t(i - Min));
         }
     }
     constexpr auto get(Key key) const -> std::optional<Value> {
@@ -173,11 +200,10 @@ class indexed_map {
         }
     }
     constexpr auto operator[](Key key) const -> std::optional<Value> {
-        auto i = BaseT(key);
-        if (i < Min || i > Max || !present[i - Min]) {
-            return std::nullopt;
+        if (contains(key)) {
+            return vals[ordinals[size_t(BaseT(key) - Min)]];
         } else {
-            return vals[i - Min];
+            return std::nullopt;
         }
     }
 };
@@ -227,91 +253,23 @@ constexpr void sort(T* values) {
         }
     }
 }
-// Stably sorts and de-duplicates an array, returning a new number of elements
-// stably sorted with duplicates removed
-template <size_t N, class T>
-constexpr size_t sort_dedup(T* values) {
-    using detail::compare;
-    if constexpr (N <= 1) {
-        return N;
-    } else if constexpr (N == 2) {
-        auto& a = values[0];
-        auto& b = values[1];
-        if (compare(a, b) < 0) {
-            return N;
-        } else if (compare(b, a) < 0) {
-            detail::swap(a, b);
-            return N;
-        } else {
-            // We return 1 b/c we're discarding B
-            return 1;
-        }
-    } else {
-        size_t first_half = sort_dedup<N / 2>(values);
-        size_t second_half = sort_dedup<N - N / 2>(values + N / 2);
-
-        T buffer[N];
-        size_t count = 0;
-
-        {
-            T* dest = buffer;
-            T* a1 = values;
-            T* a2 = values + N / 2;
-            T* const end1 = a1 + first_half;
-            T* const end2 = a2 + second_half;
-            while (a1 < end1 && a2 < end2) {
-                int cmp = compare(*a1, *a2);
-                if (cmp < 0) {
-                    *dest++ = *a1++;
-                } else if (cmp > 0) {
-                    *dest++ = *a2++;
-                } else {
-                    // Discard the element from a2, since that's the duplicate
-                    *dest++ = *a1++;
-                    a2++;
-                }
-            }
-            if (a1 == end1) {
-                while (a2 < end2) {
-                    *dest++ = *a2++;
-                }
-            } else {
-                while (a1 < end1) {
-                    *dest++ = *a1++;
-                }
-            }
-            count = dest - buffer;
-        }
-        // Copy the elements back from buffer to the original array
-        for (size_t i = 0; i < count; i++) {
-            values[i] = buffer[i];
-        }
-        // Return the number of elements we placed in the resulting array
-        return count;
-    }
-}
+/**
+ * @brief Maps the values of an enum to the corresponding element of an array
+ * of Value, given in declaration order, by looking up the ordinal of each value
+ * in value_index_v. Sparse enums are split into runs of values that are close
+ * together, each with its own table (see value_index).
+ *
+ * The values aren't copied, so they must outlive the map.
+ */
 template <class Key, class Value, size_t N>
-class binary_dedup_map {
-    using Entry = map_entry<Key, Value>;
-    Value default_value {};
-    std::array<Entry, N> entries;
-    size_t count = 0;
+class value_index_map {
+    Value const* vals = nullptr;
 
    public:
-    constexpr binary_dedup_map(
-        std::array<Key, N> const& keys,
-        std::array<Value, N> const& values,
-        Value const& default_value)
-      : default_value(default_value) {
-        for (size_t i = 0; i < N; i++) {
-            entries[i] = {keys[i], values[i]};
-        }
-        // Stably sort and deduplicate entries. Compute count to be the number
-        // of entries after deduplication
-        count = sort_dedup<N>(entries.data());
-    }
+    constexpr value_index_map(std::array<Value, N> const& values)
+      : vals(values.data()) {}
     constexpr bool contains(Key key) const {
-        return binary_search(view(entries.data(), count), key) != nullptr;
+        return value_index_v<Key>.find(key) < N;
     }
     constexpr auto get(Key key) const -> std::optional<Value> {
         return (*this)[key];
@@ -324,19 +282,15 @@ class binary_dedup_map {
         }
     }
     constexpr auto operator[](Key key) const -> std::optional<Value> {
-        if (Entry const* entry = binary_search(
-                view(entries.data(), count),
-                key)) {
-            return entry->value;
+        size_t i = value_index_v<Key>.find(key);
+        if (i < N) {
+            return vals[i];
         } else {
             return std::nullopt;
         }
     }
 };
 
-template <class>
-struct from_chars_helper;
-
 // A map that returns an optional when you index into it. Returns nullopt if the
 // item wasn't found.
 template <class Key, class Value, size_t N>
@@ -344,8 +298,6 @@ class binary_map {
     using Entry = map_entry<Key, Value>;
     std::array<Entry, N> entries;
 
-    friend struct from_chars_helper<Value>;
-
    public:
     constexpr binary_map(
         std::array<Key, N> const& keys,
@@ -387,20 +339,244 @@ class binary_map {
     }
 };
 
+// Reaching this function during constant evaluation is a compile error, since
+// it isn't constexpr. It's called when perfect_hash_map fails to find a seed.
+inline void perfect_hash_map_could_not_find_a_seed() {}
+
+// Default hash for perfect_hash_map. A Hasher provides a static function
+// hash(key, seed), where a different seed should give unrelated hashes, and a
+// static function equal(a, b), which is true for any keys that hash the same
+// for every seed
+struct block8_hasher {
+    constexpr static uint64_t hash(std::string_view key, uint64_t seed) {
+        return block8_hash_seeded(key, seed);
+    }
+    constexpr static bool equal(std::string_view a, std::string_view b) {
+        return a == b;
+    }
+};
+
+// Hash for perfect_hash_map which ignores the case of ASCII letters. Case is
+// folded as each block of the key is loaded, so looking up a key doesn't make
+// a lowercase copy of it
+struct ignore_case_hasher {
+    constexpr static uint64_t hash(std::string_view key, uint64_t seed) {
+        return block8_hash_ignore_case_seeded(key, seed);
+    }
+    constexpr static bool equal(std::string_view a, std::string_view b) {
+        return equal_ignore_case(a, b);
+    }
+};
+
+// A map from strings to values, backed by a perfect hash. On construction, we
+// search for a seed for the hash, together with a displacement for each
+// bucket, such that every key is placed in a distinct slot. A lookup then
+// costs one hash, one probe into the table, and one comparison against the key
+// stored in that slot.
+template <class Value, size_t N, class Hasher = block8_hasher>
+class perfect_hash_map {
+    using Entry = map_entry<std::string_view, Value>;
+
+    // The table has at least one empty slot, and there are on average two keys
+    // per bucket
+    constexpr static size_t table_size = bit_ceil_minus_1(N) + 1;
+    constexpr static size_t bucket_count = bit_ceil_minus_1(N / 2) + 1;
+    constexpr static uint64_t max_seeds = 64;
+
+    uint64_t seed = 0;
+    std::array<unsigned, bucket_count> displacements {};
+    std::array<Entry, table_size> entries {};
+
+    constexpr static uint64_t mix(uint64_t h) noexcept {
+        return h * 0x9e3779b97f4a7c15;
+    }
+    // The bucket is taken from the high bits of the mixed hash
+    constexpr static size_t bucket_of(uint64_t h) noexcept {
+        return ((h >> 32) * bucket_count) >> 32;
+    }
+    // The step is odd and the table size is a power of 2, so as the
+    // displacement ranges over [0, table_size) the slot visits every position
+    // in the table exactly once
+    constexpr static size_t slot_of(uint64_t h, uint64_t displacement) noexcept {
+        uint64_t start = h & 0xffffffff;
+        uint64_t step = (h >> 32) | 1;
+        return (start + displacement * step) & (table_size - 1);
+    }
+
+    constexpr bool try_seed(
+        std::array<std::string_view, N> const& keys,
+        std::array<Value, N> const& values) {
+        uint64_t hashes[N] {};
+        size_t bucket_start[bucket_count + 1] {};
+        for (size_t i = 0; i < N; i++) {
+            hashes[i] = mix(Hasher::hash(keys[i], seed));
+            bucket_start[bucket_of(hashes[i]) + 1]++;
+        }
+        for (size_t b = 0; b < bucket_count; b++) {
+            bucket_start[b + 1] += bucket_start[b];
+        }
+
+        // Group the keys by bucket
+        size_t members[N] {};
+        {
+            size_t filled[bucket_count] {};
+            for (size_t i = 0; i < N; i++) {
+                size_t b = bucket_of(hashes[i]);
+                members[bucket_start[b] + filled[b]++] = i;
+            }
+        }
+
+        // Larger buckets are harder to place, so we place them first. Keys
+        // are N - size so that the stable sort puts the largest buckets first
+        map_entry<size_t, size_t> order[bucket_count] {};
+        for (size_t b = 0; b < bucket_count; b++) {
+            order[b] = {N - (bucket_start[b + 1] - bucket_start[b]), b};
+        }
+        detail::sort<bucket_count>(order);
+
+        bool occupied[table_size] {};
+        for (auto const& bucket : order) {
+            size_t b = bucket.value;
+            size_t const* first = members + bucket_start[b];
+            size_t const* last = members + bucket_start[b + 1];
+            if (first == last) {
+                break;
+            }
+            bool placed = false;
+            for (size_t d = 0; d < table_size && !placed; d++) {
+                size_t const* it = first;
+                for (; it != last; ++it) {
+                    size_t slot = slot_of(hashes[*it], d);
+                    if (occupied[slot]) {
+                        break;
+                    }
+                    occupied[slot] = true;
+                }
+                placed = it == last;
+                // Release any slots we claimed if the bucket didn't fit
+                if (!placed) {
+                    while (it != first) {
+                        occupied[slot_of(hashes[*--it], d)] = false;
+                    }
+                } else {
+                    displacements[b] = unsigned(d);
+                }
+            }
+            if (!placed) {
+                return false;
+            }
+        }
+
+        // Empty slots hold the first key. That key is placed in its own slot,
+        // so it can never be matched against an empty slot.
+        for (auto& entry : entries) {
+            entry = {keys[0], values[0]};
+        }
+        for (size_t i = 0; i < N; i++) {
+            uint64_t h = hashes[i];
+            entries[slot_of(h, displacements[bucket_of(h)])] = {
+                keys[i],
+                values[i]};
+        }
+        return true;
+    }
+
+   public:
+    constexpr perfect_hash_map(
+        std::array<std::string_view, N> const& keys,
+        std::array<Value, N> const& values) {
+        if constexpr (N > 0) {
+            for (; seed < max_seeds; seed++) {
+                if (try_seed(keys, values)) {
+                    return;
+                }
+            }
+            perfect_hash_map_could_not_find_a_seed();
+        }
+    }
+    // hash() and probe() split a lookup in two, so that callers looking up
+    // many keys can hash several keys before touching the table. probe()
+    // returns the only entry which could hold a key with the given hash. The
+    // caller must still compare the key. Requires N > 0
+    constexpr uint64_t hash(std::string_view key) const noexcept {
+        return mix(Hasher::hash(key, seed));
+    }
+    constexpr auto probe(uint64_t h) const noexcept -> Entry const& {
+        return entries[slot_of(h, displacements[bucket_of(h)])];
+    }
+    constexpr auto find(std::string_view key) const noexcept -> Entry const* {
+        if constexpr (N == 0) {
+            return nullptr;
+        } else {
+            Entry const& entry = probe(hash(key));
+            return Hasher::equal(entry.key, key) ? &entry : nullptr;
+        }
+    }
+    constexpr bool contains(std::string_view key) const {
+        return find(key) != nullptr;
+    }
+    constexpr auto get(std::string_view key) const -> std::optional<Value> {
+        return (*this)[key];
+    }
+    constexpr auto get(std::string_view key, Value default_value) const
+        -> Value {
+        if (Entry const* entry = find(key)) {
+            return entry->value;
+        } else {
+            return default_value;
+        }
+    }
+    constexpr auto operator[](std::string_view key) const
+        -> std::optional<Value> {
+        if (Entry const* entry = find(key)) {
+            return entry->value;
+        } else {
+            return std::nullopt;
+        }
+    }
+};
+
+// If we have a large sparse map, select value_index_map, which only builds
+// tables for the runs of values that are close together. Otherwise, select the
+// indexed map, which has a single table covering every value
+template <class Key, class Value, size_t N, class BaseT, BaseT Min, BaseT Max>
+using select_map_t = std::conditional_t<
+    (Max - Min > 2 * N + 256),
+    value_index_map<Key, Value, N>,
+    indexed_map<Key, Value, N, BaseT, Min, Max>>;
+
 template <class Key, class Value, size_t N, class BaseT, BaseT Min, BaseT Max>
 constexpr auto select_map(
     std::array<Key, N> const& keys,
-    std::array<Value, N> const& values,
-    Value const& default_value) {
-    // If we have a large sparse map, select binary_dedup_map. Otherwise, select
-    // the indexed map, which should be faster, but may use more memory
+    std::array<Value, N> const& values)
+    -> select_map_t<Key, Value, N, BaseT, Min, Max> {
     if constexpr (Max - Min > 2 * N + 256) {
-        return binary_dedup_map<Key, Value, N>(keys, values, default_value);
+        return value_index_map<Key, Value, N>(values);
+    } else {
+        return indexed_map<Key, Value, N, BaseT, Min, Max>(keys, values);
+    }
+}
+
+// Below this size, a binary search over the sorted names is at least as fast as
+// hashing the name (see bench/nav_name_lookup.cpp)
+constexpr size_t perfect_hash_min_size = 16;
+
+// Selects a map from names to values. Small maps use binary_map, and larger
+// maps use perfect_hash_map, which looks up a name in constant time.
+template <class Value, size_t N>
+using select_name_map_t = std::conditional_t<
+    (N < perfect_hash_min_size),
+    binary_map<std::string_view, Value, N>,
+    perfect_hash_map<Value, N>>;
+
+template <class Value, size_t N>
+constexpr auto select_name_map(
+    std::array<std::string_view, N> const& keys,
+    std::array<Value, N> const& values) -> select_name_map_t<Value, N> {
+    if constexpr (N < perfect_hash_min_size) {
+        return binary_map<std::string_view, Value, N>(keys, values);
     } else {
-        return indexed_map<Key, Value, BaseT, Min, Max>(
-            keys,
-            values,
-            default_value);
+        return perfect_hash_map<Value, N>(keys, values);
     }
 }
 
@@ -479,30 +655,99 @@ constexpr Result fold(Elem const* values, size_t N, Result initial, F func) {
     }
     return initial;
 }
+// Counts the names of an enum which are distinct when case is ignored
+template <class Enum>
+constexpr size_t count_names_ignoring_case() {
+    auto const& sorted = name_index_v<Enum, true>.ordinals;
+    size_t count = 0;
+    for (size_t i = 0; i < num_states<Enum>; i++) {
+        if (i == 0
+            || compare_names<true>(
+                   enum_names<Enum>[sorted[i - 1]],
+                   enum_names<Enum>[sorted[i]])
+                   != 0) {
+            count++;
+        }
+    }
+    return count;
+}
+
+// Builds the map used by enum_traits<Enum>::get_value_ignore_case. Keys refer
+// to the enum's name block. If several names only differ in case, the one
+// declared first is kept (name_index sorts stably, so it comes first)
+template <class Enum, size_t N = count_names_ignoring_case<Enum>()>
+constexpr auto make_ignore_case_name_map() {
+    auto const& sorted = name_index_v<Enum, true>.ordinals;
+    std::array<std::string_view, N> keys {};
+    std::array<Enum, N> values {};
+    size_t count = 0;
+    for (size_t i = 0; i < num_states<Enum>; i++) {
+        std::string_view name = enum_names<Enum>[sorted[i]];
+        if (count == 0 || compare_names<true>(keys[count - 1], name) != 0) {
+            keys[count] = name;
+            values[count] = enum_values<Enum>[sorted[i]];
+            count++;
+        }
+    }
+    return perfect_hash_map<Enum, N, ignore_case_hasher>(keys, values);
+}
+
+// The map used by enum_traits<Enum>::get_value_ignore_case. Case is folded
+// while hashing and comparing names, so names aren't copied or converted to
+// lowercase. The type of the map depends on how many names are distinct when
+// case is ignored, which takes a sort to find out, so it isn't a member of
+// enum_traits: the sort only happens if get_value_ignore_case is used
+template <class Enum>
+constexpr auto ignore_case_name_map_v = make_ignore_case_name_map<Enum>();
+
+// Copies the values of an enum declared with NAV_DECLARE_ENUM into an array
+template <class Enum, size_t N = num_states<Enum>>
+constexpr auto get_value_array() -> std::array<Enum, N> {
+    std::array<Enum, N> result {};
+    for (size_t i = 0; i < N; i++) {
+        result[i] = enum_values<Enum>[i];
+    }
+    return result;
+}
+// Gets the names of an enum declared with NAV_DECLARE_ENUM as an array of
+// string views. The names refer to the enum's name block.
+template <class Enum, size_t N = num_states<Enum>>
+constexpr auto get_name_array() -> std::array<std::string_view, N> {
+    std::array<std::string_view, N> result {};
+    for (size_t i = 0; i < N; i++) {
+        result[i] = enum_names<Enum>[i];
+    }
+    return result;
+}
+// Provides the information enum_traits is built from, obtained from the enum
+// declaration made by NAV_DECLARE_ENUM
 template <class Enum>
 struct traits_impl {
+    using base_type = std::underlying_type_t<Enum>;
     // Allows checks for the existence of nav enum traits
-    constexpr static bool is_nav_enum = false;
+    constexpr static bool is_nav_enum = nav::is_nav_enum<Enum>;
+    constexpr static std::string_view qualified_type_name =
+        enum_type_info<Enum>::qualified_type_name;
+    constexpr static std::string_view type_name =
+        enum_type_info<Enum>::type_name;
+    constexpr static size_t size = num_states<Enum>;
+    constexpr static std::array<Enum, size> values = get_value_array<Enum>();
+    constexpr static std::array<std::string_view, size>
+        names_raw = get_name_array<Enum>();
 };
 
+} // namespace nav::detail
 
+namespace nav {
 /**
- * @brief Compute the smallest number of the form 2^N-1 such that 2^N-1 >= i
+ * @brief Names, values, and lookup tables for an enum.
  *
- * @param i
- * @return constexpr size_t
+ * Each table is a static member with an explicitly declared type, so its
+ * initializer is only instantiated (and evaluated) if that table is used.
+ * Looking up names from values doesn't build the maps from names to values,
+ * and vice versa. None of the types depend on a table that takes a sort to
+ * build.
  */
-constexpr size_t bit_ceil_minus_1(size_t i) {
-    size_t ceil = 0;
-    while (ceil < i) {
-        ceil <<= 1;
-        ceil |= 1;
-    }
-    return ceil;
-}
-} // namespace nav::detail
-
-namespace nav {
 template <class EnumType>
 struct enum_traits : private detail::traits_impl<EnumType> {
    private:
@@ -513,41 +758,37 @@ struct enum_traits : private detail::traits_impl<EnumType> {
     using base_type = typename super::base_type;
     using super::is_nav_enum;
     using super::qualified_type_name;
+    using super::size;
     using super::type_name;
     using super::values;
-    constexpr static auto size = values.size();
-    constexpr static auto name_lengths = detail::map_array(
+    constexpr static std::array<size_t, size> name_lengths = detail::map_array(
         super::names_raw,
         [](std::string_view name) { return name.size(); });
 
    private:
-    constexpr static size_t name_block_buffer_size = size
-                                                   + detail::fold(
-                                                         name_lengths.data(),
-                                                         size,
-                                                         0,
-                                                         [](size_t acc,
-                                                            size_t elem) {
-                                                             return acc + elem;
-                                                         });
-    constexpr static auto
+    // Names are separated by '\0'. The size is known from the enum's name
+    // block, without building name_lengths
+    constexpr static size_t name_block_buffer_size =
+        enum_name_list<EnumType>::block_type::block_size()
+        + (NAV_ADD_NULL_TERMINATORS ? 0 : size);
+    constexpr static std::array<char, name_block_buffer_size>
         name_block = detail::static_cat<name_block_buffer_size>(
             super::names_raw,
             '\0');
-    constexpr static auto lowercase_name_block = map_array(
-        name_block,
-        detail::to_lower);
+    constexpr static std::array<char, name_block_buffer_size>
+        lowercase_name_block = map_array(name_block, detail::to_lower);
 
    public:
     /* A list of all the names in the enum, in declaration order */
-    constexpr static auto names = detail::split_by_lengths_assuming_sep(
-        name_lengths,
-        name_block.data());
+    constexpr static std::array<std::string_view, size>
+        names = detail::split_by_lengths_assuming_sep(
+            name_lengths,
+            name_block.data());
 
    public:
     /* All the enum names, but lowercase. Provided to support lookup
      * operations that ignore case. */
-    constexpr static auto
+    constexpr static std::array<std::string_view, size>
         lowercase_names = detail::split_by_lengths_assuming_sep(
             name_lengths,
             lowercase_name_block.data());
@@ -555,55 +796,38 @@ struct enum_traits : private detail::traits_impl<EnumType> {
         name_lengths.data());
     constexpr static base_type min = detail::min_base_value<base_type>(values);
     constexpr static base_type max = detail::max_base_value<base_type>(values);
-    constexpr static auto values_to_names = detail::
-        select_map<EnumType, std::string_view, size, base_type, min, max>(
-            values,
-            names,
-            "<unnamed>");
-    constexpr static auto
+    constexpr static detail::
+        select_map_t<EnumType, std::string_view, size, base_type, min, max>
+            values_to_names = detail::select_map<
+                EnumType,
+                std::string_view,
+                size,
+                base_type,
+                min,
+                max>(values, names);
+    constexpr static detail::binary_map<std::string_view, EnumType, size>
         names_to_values = detail::binary_map<std::string_view, EnumType, size>(
             names,
             values);
-    constexpr static auto lowercase_names_to_values = detail::
-        binary_map<std::string_view, EnumType, size>(lowercase_names, values);
+    /* Map used by get_value. Large enums look up names via a perfect hash */
+    constexpr static detail::select_name_map_t<EnumType, size>
+        name_lookup = detail::select_name_map(names, values);
     constexpr static std::optional<EnumType> get_value(std::string_view name) {
-        return names_to_values[name];
+        return name_lookup[name];
     }
     constexpr static EnumType get_value(
         std::string_view name,
         EnumType alternative) {
-        return names_to_values.get(name, alternative);
+        return name_lookup.get(name, alternative);
     }
     constexpr static std::optional<EnumType> get_value_ignore_case(
         std::string_view name) {
-        if (name.size() > max_name_length) {
-            return std::nullopt;
-        } else {
-            char buffer[max_name_length + 1];
-            for (size_t i = 0; i < name.size(); i++) {
-                buffer[i] = detail::to_lower(name[i]);
-            }
-            buffer[name.size()] = '\0';
-            return lowercase_names_to_values[std::string_view(
-                buffer,
-                names.size())];
-        }
+        return detail::ignore_case_name_map_v<EnumType>[name];
     }
     constexpr static EnumType get_value_ignore_case(
         std::string_view name,
         EnumType alternative) {
-        if (name.size() > max_name_length) {
-            return alternative;
-        } else {
-            char buffer[max_name_length + 1];
-            for (size_t i = 0; i < name.size(); i++) {
-                buffer[i] = detail::to_lower(name[i]);
-            }
-            buffer[name.size()] = '\0';
-            return lowercase_names_to_values.get(
-                std::string_view(buffer, names.size()),
-                alternative);
-        }
+        return detail::ignore_case_name_map_v<EnumType>.get(name, alternative);
     }
     constexpr static std::optional<std::string_view> get_name(EnumType value) {
         return values_to_names[value];
@@ -614,9 +838,4 @@ struct enum_traits : private detail::traits_impl<EnumType> {
         return values_to_names.get(value, alternative);
     }
 };
-
-#if __cpp_concepts >= 201907L
-template <class T>
-concept nav_enum = is_nav_enum<T>;
-#endif
 } // namespace nav
@@ -0,0 +1,108 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <nav/nav_containers.hpp>
+
+namespace nav::detail {
+// Size of a cache line on the targets we care about. Data written by different
+// threads is aligned to this, so that writes to one don't invalidate the other
+// (false sharing). std::hardware_destructive_interference_size isn't used
+// because its value may differ between translation units
+constexpr size_t cache_line_size = 64;
+} // namespace nav::detail
+
+namespace nav {
+/**
+ * @brief A set of values of an enum which can be read and updated by many
+ * threads at once without a lock. Like nav::enum_set, it holds one bit per
+ * ordinal. Each group of 64 ordinals is a std::atomic<uint64_t> on a cache
+ * line of its own, so updates to values in different groups don't contend.
+ *
+ * insert, erase, and contains are a single atomic operation on one word.
+ * snapshot() copies the set into a nav::enum_set, which can then be iterated
+ * with no further synchronization. Each word is read atomically, so for enums
+ * with at most 64 values the snapshot is the state of the set at one instant.
+ * With more values, the words are read one after another, and an update made
+ * during the snapshot may be seen in one word but not another.
+ *
+ * @tparam Enum the enumeration type
+ */
+template <class Enum>
+class atomic_enum_set {
+   public:
+    using set_type = enum_set<Enum>;
+    constexpr static size_t num_words = set_type::num_words;
+    constexpr static bool is_always_lock_free =
+        std::atomic<uint64_t>::is_always_lock_free;
+
+   private:
+    struct alignas(detail::cache_line_size) shard {
+        std::atomic<uint64_t> bits {0};
+    };
+    std::array<shard, num_words> shards {};
+
+    constexpr static uint64_t bit_of(size_t i) noexcept {
+        return uint64_t(1) << (i % 64);
+    }
+
+   public:
+    atomic_enum_set() = default;
+    explicit atomic_enum_set(set_type const& set) noexcept {
+        store(set, std::memory_order_relaxed);
+    }
+    atomic_enum_set(atomic_enum_set const&) = delete;
+    atomic_enum_set& operator=(atomic_enum_set const&) = delete;
+
+    // Returns false if the value was already in the set, or has no name
+    bool insert(
+        Enum value,
+        std::memory_order order = std::memory_order_seq_cst) noexcept {
+        size_t i = ordinal_of(value);
+        if (i >= num_states<Enum>) {
+            return false;
+        }
+        uint64_t bit = bit_of(i);
+        return (shards[i / 64].bits.fetch_or(bit, order) & bit) == 0;
+    }
+    // Returns false if the value wasn't in the set
+    bool erase(
+        Enum value,
+        std::memory_order order = std::memory_order_seq_cst) noexcept {
+        size_t i = ordinal_of(value);
+        if (i >= num_states<Enum>) {
+            return false;
+        }
+        uint64_t bit = bit_of(i);
+        return (shards[i / 64].bits.fetch_and(~bit, order) & bit) != 0;
+    }
+    bool contains(
+        Enum value,
+        std::memory_order order = std::memory_order_seq_cst) const noexcept {
+        size_t i = ordinal_of(value);
+        return i < num_states<Enum>
+            && (shards[i / 64].bits.load(order) & bit_of(i)) != 0;
+    }
+
+    set_type snapshot(
+        std::memory_order order = std::memory_order_seq_cst) const noexcept {
+        std::array<uint64_t, num_words> bits {};
+        for (size_t i = 0; i < num_words; i++) {
+            bits[i] = shards[i].bits.load(order);
+        }
+        return set_type::from_bits(bits);
+    }
+    // Replaces the contents of the set. Like snapshot(), this is one atomic
+    // store per word
+    void store(
+        set_type const& set,
+        std::memory_order order = std::memory_order_seq_cst) noexcept {
+        for (size_t i = 0; i < num_words; i++) {
+            shards[i].bits.store(set.bits()[i], order);
+        }
+    }
+    void clear(std::memory_order order = std::memory_order_seq_cst) noexcept {
+        store(set_type(), order);
+    }
+};
+} // namespace nav
@@ -0,0 +1,405 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <nav/core.hpp>
+#include <string_view>
+
+namespace nav::detail {
+// Number of names looked up together. Every name in a group is hashed and has
+// its slot prefetched before any of them are compared, so that the loads from
+// the table overlap
+constexpr size_t batch_group_size = 8;
+
+inline void prefetch(void const* ptr) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(ptr);
+#else
+    (void)ptr;
+#endif
+}
+
+// Loads bytes in little-endian order. Compilers merge these into a single load
+constexpr uint64_t load_le4(char const* ptr) noexcept {
+    return load_byte(ptr, 0) | load_byte(ptr, 1) | load_byte(ptr, 2)
+         | load_byte(ptr, 3);
+}
+constexpr uint64_t load_le8(char const* ptr) noexcept {
+    return load_le4(ptr) | load_le4(ptr + 4) << 32;
+}
+
+// The size of a name, together with its first and last 8 bytes. These overlap
+// for names shorter than 16 bytes, so names of up to 16 bytes are equal
+// exactly when their fingerprints are equal. Longer names must also compare
+// the bytes in between.
+struct name_fingerprint {
+    uint64_t head = 0;
+    uint64_t tail = 0;
+    uint64_t size = 0;
+
+    constexpr bool operator==(name_fingerprint const& other) const noexcept {
+        return ((head ^ other.head) | (tail ^ other.tail) | (size ^ other.size))
+            == 0;
+    }
+};
+constexpr int compare(
+    name_fingerprint const& a,
+    name_fingerprint const& b) noexcept {
+    if (a.head != b.head) {
+        return a.head < b.head ? -1 : 1;
+    } else if (a.tail != b.tail) {
+        return a.tail < b.tail ? -1 : 1;
+    } else if (a.size != b.size) {
+        return a.size < b.size ? -1 : 1;
+    } else {
+        return 0;
+    }
+}
+
+// Computes a fingerprint without reading outside the name, using two
+// overlapping loads. Names shorter than 4 bytes are read a byte at a time
+constexpr name_fingerprint fingerprint_of(std::string_view name) noexcept {
+    char const* str = name.data();
+    size_t size = name.size();
+    if (size >= 8) {
+        return {load_le8(str), load_le8(str + size - 8), size};
+    } else if (size >= 4) {
+        return {load_le4(str), load_le4(str + size - 4), size};
+    } else if (size > 0) {
+        return {
+            load_byte(str, 0) | load_byte(str + size / 2, 0) << 8
+                | load_byte(str + size - 1, 0) << 16,
+            0,
+            size};
+    } else {
+        return {};
+    }
+}
+
+// Hashes a name by its fingerprint. This reads at most 16 bytes of the name,
+// and doesn't loop over the name, so hashing several names at once overlaps
+// well. Names with the same fingerprint collide, so the table can only be used
+// if every fingerprint is unique (see batch_lookup)
+struct fingerprint_hasher {
+    constexpr static uint64_t hash(std::string_view key, uint64_t seed) {
+        name_fingerprint fp = fingerprint_of(key);
+        uint64_t h = (fp.head + seed) * 0x9e3779b97f4a7c15;
+        h ^= (fp.tail + fp.size) * 0xc2b2ae3d27d4eb4f;
+        h ^= h >> 32;
+        h *= 0xd6e8feb86659fd93;
+        return h ^ (h >> 32);
+    }
+    constexpr static bool equal(std::string_view a, std::string_view b) {
+        return a == b;
+    }
+};
+
+// Compares bytes [8, size - 8) of two names with the same fingerprint, which
+// are longer than 16 bytes. Names of up to 32 bytes need two more 8 byte loads
+inline bool equal_middle(char const* a, char const* b, size_t size) noexcept {
+    if (size <= 32) {
+        return ((load_le8(a + 8) ^ load_le8(b + 8))
+                | (load_le8(a + size - 16) ^ load_le8(b + size - 16)))
+            == 0;
+    }
+    return std::memcmp(a + 8, b + 8, size - 16) == 0;
+}
+
+template <class Enum>
+struct batch_entry {
+    Enum value {};
+    name_fingerprint fingerprint {};
+};
+
+template <class Enum>
+struct batch_lookup {
+    using traits = enum_traits<Enum>;
+    constexpr static size_t size = traits::size;
+
+    constexpr static bool has_unique_fingerprints() {
+        std::array<name_fingerprint, size> fingerprints {};
+        for (size_t i = 0; i < size; i++) {
+            fingerprints[i] = fingerprint_of(traits::names[i]);
+        }
+        detail::sort<size>(fingerprints.data());
+        for (size_t i = 1; i < size; i++) {
+            if (fingerprints[i - 1] == fingerprints[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // If two names share a fingerprint (they're longer than 16 bytes, and
+    // differ only in the middle), we fall back to looking up each name with
+    // enum_traits<Enum>::get_value
+    constexpr static bool use_table = size > 0 && has_unique_fingerprints();
+
+    constexpr static auto make_table() {
+        std::array<batch_entry<Enum>, size> entries {};
+        for (size_t i = 0; i < size; i++) {
+            entries[i] = {
+                traits::values[i],
+                fingerprint_of(traits::names[i])};
+        }
+        return perfect_hash_map<batch_entry<Enum>, size, fingerprint_hasher>(
+            traits::names,
+            entries);
+    }
+};
+
+template <class Enum>
+constexpr auto batch_table = batch_lookup<Enum>::make_table();
+
+// Looks up count names, where get_name(i) returns the ith name. Writes the
+// value of each name to values[i], and sets bit i of valid if it was found.
+// Returns the number of names that were found.
+template <class Enum, class GetName>
+size_t parse_names_impl(
+    size_t count,
+    GetName get_name,
+    Enum* values,
+    uint64_t* valid) {
+    size_t num_found = 0;
+    for (size_t i = 0; i < (count + 63) / 64; i++) {
+        valid[i] = 0;
+    }
+
+    if constexpr (!batch_lookup<Enum>::use_table) {
+        for (size_t i = 0; i < count; i++) {
+            auto value = enum_traits<Enum>::get_value(get_name(i));
+            values[i] = value ? *value : Enum();
+            valid[i / 64] |= uint64_t(bool(value)) << (i % 64);
+            num_found += bool(value);
+        }
+    } else {
+        constexpr auto const& table = batch_table<Enum>;
+        using entry_type = map_entry<std::string_view, batch_entry<Enum>>;
+
+        for (size_t start = 0; start < count; start += batch_group_size) {
+            size_t group_size = std::min(batch_group_size, count - start);
+
+            // Stage 1: hash each name, and prefetch the slot it maps to
+            std::string_view names[batch_group_size];
+            entry_type const* entries[batch_group_size];
+            for (size_t j = 0; j < group_size; j++) {
+                names[j] = get_name(start + j);
+                entries[j] = &table.probe(table.hash(names[j]));
+                prefetch(entries[j]);
+            }
+            // Stage 2: compare each name against the name in its slot. The
+            // fingerprint covers the whole name for names of up to 16 bytes,
+            // so only longer names need to compare the bytes in between
+            for (size_t j = 0; j < group_size; j++) {
+                std::string_view name = names[j];
+                name_fingerprint fp = fingerprint_of(name);
+                entry_type const& entry = *entries[j];
+                bool found = entry.value.fingerprint == fp
+                          && (fp.size <= 16
+                              || equal_middle(
+                                     entry.key.data(),
+                                     name.data(),
+                                     fp.size));
+                size_t i = start + j;
+                values[i] = found ? entry.value.value : Enum();
+                valid[i / 64] |= uint64_t(found) << (i % 64);
+                num_found += found;
+            }
+        }
+    }
+    return num_found;
+}
+
+// Copies size characters to dest, and returns the end of the copy. The source
+// may be null if size is 0 (for instance, when it comes from an empty
+// string_view), which memcpy doesn't allow
+inline char* append_chars(char* dest, char const* src, size_t size) noexcept {
+    if (size > 0) {
+        std::memcpy(dest, src, size);
+    }
+    return dest + size;
+}
+
+// Copies a name out of a block of BlockSize bytes to dest. Names of up to 32
+// bytes are copied with a single fixed size copy, which compiles to a pair of
+// vector loads and stores instead of a call to memcpy. This may copy past the
+// end of the name, which is fine as long as it stays inside both buffers:
+// anything written past the name is overwritten by whatever is written next.
+// Near the end of either buffer, and for blocks smaller than 32 bytes, this
+// uses memcpy instead.
+template <size_t BlockSize>
+inline char* copy_name(
+    char* dest,
+    char const* dest_end,
+    char const* src,
+    char const* src_end,
+    size_t size) noexcept {
+    if constexpr (BlockSize >= 32) {
+        if (size <= 32 && dest_end - dest >= 32 && src_end - src >= 32) {
+            std::memcpy(dest, src, 32);
+            return dest + size;
+        }
+    }
+    return append_chars(dest, src, size);
+}
+
+// Size of the name with the given ordinal, read from the offsets table of the
+// enum's name block. Ordinals equal to num_states<Enum> have no name, and are
+// given the size of the fallback instead
+template <class Enum>
+inline size_t name_size_of(size_t ordinal, size_t fallback_size) noexcept {
+    constexpr size_t N = num_states<Enum>;
+    auto const& block = enum_name_list<Enum>::get_name_block();
+    // offsets[N] is the end of the block, so offsets[N + 1] is never read
+    size_t i = ordinal < N ? ordinal : 0;
+    size_t size = block.offsets[i + 1] - block.offsets[i]
+                - NAV_ADD_NULL_TERMINATORS;
+    return ordinal < N ? size : fallback_size;
+}
+} // namespace nav::detail
+
+namespace nav {
+/**
+ * @brief Number of 64-bit words needed for a validity bitmap of count names
+ */
+constexpr size_t bitmap_words(size_t count) noexcept {
+    return (count + 63) / 64;
+}
+
+/**
+ * @brief Look up the value of every name in names. The result is the same as
+ * calling enum_traits<Enum>::get_value on each name, but names are looked up
+ * in groups, using a table that's hashed by the first and last 8 bytes of each
+ * name.
+ *
+ * @param names the names to look up
+ * @param values output array of names.size() values. If a name isn't found,
+ * its value is set to Enum()
+ * @param valid output bitmap of bitmap_words(names.size()) words. Bit i % 64 of
+ * valid[i / 64] is set if names[i] was found
+ * @return size_t the number of names that were found
+ */
+template <class Enum>
+size_t parse_names(
+    view<std::string_view> names,
+    Enum* values,
+    uint64_t* valid) {
+    return detail::parse_names_impl<Enum>(
+        names.size(),
+        [names](size_t i) { return names[i]; },
+        values,
+        valid);
+}
+
+/**
+ * @brief Look up the value of every name in a packed buffer. Name i is the
+ * range [offsets[i], offsets[i + 1]) of data, so there is one more offset than
+ * there are names. This is the same layout as nav::string_block.
+ *
+ * @param data buffer holding the names
+ * @param offsets offset of each name in data, followed by the end of the last
+ * name
+ * @param values output array of offsets.size() - 1 values. If a name isn't
+ * found, its value is set to Enum()
+ * @param valid output bitmap of bitmap_words(offsets.size() - 1) words. Bit
+ * i % 64 of valid[i / 64] is set if name i was found
+ * @return size_t the number of names that were found
+ */
+template <class Enum, class Offset>
+size_t parse_names(
+    char const* data,
+    view<Offset> offsets,
+    Enum* values,
+    uint64_t* valid) {
+    size_t count = offsets.size() == 0 ? 0 : offsets.size() - 1;
+    return detail::parse_names_impl<Enum>(
+        count,
+        [data, offsets](size_t i) {
+            return std::string_view(
+                data + offsets[i],
+                offsets[i + 1] - offsets[i]);
+        },
+        values,
+        valid);
+}
+
+/**
+ * @brief Compute the number of characters written by write_names for the given
+ * values. Use this to size the buffer passed to write_names.
+ *
+ * @param values the values to name
+ * @param separator written between each pair of names
+ * @param fallback written in place of values that don't have a name
+ * @return size_t the total size of the names, including separators
+ */
+template <class Enum>
+size_t names_size(
+    view<Enum> values,
+    std::string_view separator,
+    std::string_view fallback = {}) noexcept {
+    if (values.size() == 0) {
+        return 0;
+    }
+    // Sizes are summed without branching on whether a value has a name, so
+    // that the loop can be vectorized
+    size_t total = separator.size() * (values.size() - 1);
+    for (Enum value : values) {
+        size_t ordinal = detail::value_index_v<Enum>.find(value);
+        total += detail::name_size_of<Enum>(ordinal, fallback.size());
+    }
+    return total;
+}
+
+/**
+ * @brief Write the name of every value into dest, with separator between each
+ * pair of names. This is equivalent to joining the result of name_of on each
+ * value, but names are copied directly out of the enum's name block, without
+ * any intermediate strings.
+ *
+ * @param values the values to name
+ * @param dest the buffer to write the names to. No null terminator is written
+ * @param dest_size the size of dest, which must be at least
+ * names_size(values, separator, fallback). Short names are copied in fixed
+ * size chunks, so bytes in [return value, dest + dest_size) may be overwritten.
+ * Pass names_size(...) as dest_size to keep the rest of a larger buffer intact
+ * @param separator written between each pair of names
+ * @param fallback written in place of values that don't have a name
+ * @return char* one past the last character of the names
+ */
+template <class Enum>
+char* write_names(
+    view<Enum> values,
+    char* dest,
+    size_t dest_size,
+    std::string_view separator,
+    std::string_view fallback = {}) noexcept {
+    constexpr size_t N = num_states<Enum>;
+    using block_type = typename enum_name_list<Enum>::block_type;
+    constexpr size_t block_size = block_type::block_size();
+    auto const& block = enum_name_list<Enum>::get_name_block();
+    char const* block_end = block.data + block_size;
+    char const* dest_end = dest + dest_size;
+    for (size_t i = 0; i < values.size(); i++) {
+        if (i > 0) {
+            dest = detail::append_chars(
+                dest,
+                separator.data(),
+                separator.size());
+        }
+        size_t ordinal = detail::value_index_v<Enum>.find(values[i]);
+        size_t size = detail::name_size_of<Enum>(ordinal, fallback.size());
+        if (ordinal < N) {
+            char const* name = block.data + block.offsets[ordinal];
+            dest = detail::copy_name<block_size>(
+                dest,
+                dest_end,
+                name,
+                block_end,
+                size);
+        } else {
+            dest = detail::append_chars(dest, fallback.data(), size);
+        }
+    }
+    return dest;
+}
+} // namespace nav
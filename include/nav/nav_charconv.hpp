@@ -1,73 +1,457 @@
 #pragma once
 #include <charconv>
+#include <cstring>
 #include <nav/nav_core.hpp>
+#include <nav/nav_hashmap.hpp>
+#include <type_traits>
 
 namespace nav::detail {
-template <class Entry, class Fn>
-auto find_longest_prefix(view<Entry> vals, std::string_view string, Fn get_key)
-    -> Entry const* {
-    // TODO: Fix me
-    Entry const* result = nullptr;
-    size_t lower_i = 0;
-    size_t upper_i = vals.size() - 1;
-    while (lower_i <= upper_i) {
-        size_t i = (lower_i + upper_i) / 2;
-        std::string_view entry = get_key(vals[i]);
-        std::string_view search_key = string.substr(0, entry.size());
-        auto cmp = compare(entry, search_key);
-
-        if (cmp < 0) {
-            lower_i = i + 1;
-        } else if (cmp > 0) {
-            upper_i = i - 1;
-        } else {
-            // If the size of the entry is the same as the string size, we found
-            // a perfect match. Otherwise we've obtained a lower bound for the
-            // possible value. A shorter prefix should never appear after a
-            // longer prefix, so this works
-            if (entry.size() == string.size()) {
-                return &vals[i];
-            } else {
-                upper_i = i - 1;
-                result = &vals[i];
+constexpr size_t common_prefix_size(
+    std::string_view a,
+    std::string_view b) noexcept {
+    size_t size = a.size() < b.size() ? a.size() : b.size();
+    size_t i = 0;
+    while (i < size && a[i] == b[i]) {
+        i++;
+    }
+    return i;
+}
+
+// Compares str to the characters at the start of other, which must hold at
+// least str.size() characters. Most edges in a name_trie are short, so this
+// compares 8 bytes at a time inline, rather than calling memcmp. The last few
+// bytes are compared with load_tail, as block8_hash does
+constexpr bool equal_chars(std::string_view str, char const* other) noexcept {
+    char const* a = str.data();
+    size_t size = str.size();
+    size_t i = 0;
+    if (!is_constant_evaluated()) {
+        for (; i + 8 <= size; i += 8) {
+            if (load_block8(a + i) != load_block8(other + i)) {
+                return false;
             }
         }
+        size_t n = size - i;
+        return n == 0
+            || load_tail(a + i, n, size) == load_tail(other + i, n, size);
+    }
+    for (; i < size; i++) {
+        if (a[i] != other[i]) {
+            return false;
+        }
     }
-    return result;
+    return true;
 }
+
+// The result of name_trie::longest_prefix
+struct prefix_match {
+    size_t ordinal {};
+    size_t size {};
+};
+
+// A trie of the names of an enum, with one node per character. This is only
+// used at compile time, to build name_trie.
+//
+// The trie is built in preorder by inserting names in sorted order. A node's
+// first child is the node after it, and its other children are linked through
+// next_sibling. Each node on the path to the previous name is remembered, so
+// that the nodes for a new name can be linked in after the common prefix.
+// Since names are sorted, a new node is always the last child of its parent.
+template <class Enum>
+struct trie_builder {
+    constexpr static size_t size = num_states<Enum>;
+
+    // Each name adds one node for every character after its common prefix
+    // with the previous name
+    constexpr static size_t count_nodes() noexcept {
+        auto const& sorted = name_index_v<Enum, false>.ordinals;
+        size_t count = 1;
+        std::string_view prev;
+        for (size_t i = 0; i < size; i++) {
+            std::string_view name = enum_names<Enum>[sorted[i]];
+            count += name.size() - common_prefix_size(prev, name);
+            prev = name;
+        }
+        return count;
+    }
+    constexpr static size_t get_max_name_size() noexcept {
+        size_t result = 0;
+        for (std::string_view name : enum_names<Enum>) {
+            result = name.size() > result ? name.size() : result;
+        }
+        return result;
+    }
+    constexpr static size_t num_nodes = count_nodes();
+    constexpr static size_t max_name_size = get_max_name_size();
+
+    std::array<bool, num_nodes> has_child {};
+    std::array<size_t, num_nodes> next_sibling {};
+    // The ordinal of the name that ends at each node, or size if no name ends
+    // there
+    std::array<size_t, num_nodes> ordinals {};
+    // The position of each node's character in the enum's name block
+    std::array<size_t, num_nodes> block_offsets {};
+    // The number of nodes in the compressed trie
+    size_t num_edges = 1;
+
+    constexpr trie_builder() {
+        auto const& sorted = name_index_v<Enum, false>.ordinals;
+        auto const& block = enum_name_list<Enum>::get_name_block();
+        std::array<size_t, max_name_size + 1> path {};
+        ordinals[0] = size;
+        size_t count = 1;
+        std::string_view prev;
+        for (size_t i = 0; i < size; i++) {
+            std::string_view name = enum_names<Enum>[sorted[i]];
+            size_t common = common_prefix_size(prev, name);
+            for (size_t depth = common; depth < name.size(); depth++) {
+                size_t node = count++;
+                ordinals[node] = size;
+                block_offsets[node] = block.offsets[sorted[i]] + depth;
+                if (depth == common && prev.size() > common) {
+                    next_sibling[path[depth + 1]] = node;
+                } else {
+                    has_child[path[depth]] = true;
+                }
+                path[depth + 1] = node;
+            }
+            ordinals[path[name.size()]] = sorted[i];
+            prev = name;
+        }
+        for (size_t node = 0; node < num_nodes; node++) {
+            if (node == 0 || ends_edge(node)) {
+                size_t child = first_child(node);
+                while (child != 0) {
+                    num_edges++;
+                    child = next_sibling[child];
+                }
+            }
+        }
+    }
+    constexpr size_t first_child(size_t node) const noexcept {
+        return has_child[node] ? node + 1 : 0;
+    }
+    // A chain of nodes with one child each is compressed into a single edge.
+    // The chain ends at a node where a name ends, or where the trie branches
+    constexpr bool ends_edge(size_t node) const noexcept {
+        return ordinals[node] != size || !has_child[node]
+            || next_sibling[node + 1] != 0;
+    }
+};
+
+template <class Enum>
+constexpr trie_builder<Enum> trie_builder_v {};
+
+// A node in a name_trie. Each node other than the root is reached by an edge,
+// which holds one or more characters of a name
+template <class Index>
+struct trie_node {
+    // The children of the node are the nodes [first_child, first_child +
+    // num_children)
+    Index first_child {};
+    Index num_children {};
+    // The ordinal of the name that ends at this node, or num_states<Enum> if
+    // no name ends here
+    Index ordinal {};
+    // The characters on the edge leading to this node are the range
+    // [edge_offset, edge_offset + edge_size) of the enum's name block
+    Index edge_offset {};
+    Index edge_size {};
+};
+
+/**
+ * @brief A compressed trie of the names of an enum, built at compile time and
+ * stored as flat arrays. Finding the longest name that's a prefix of a string
+ * reads the string once, from left to right, and never compares the same
+ * character twice.
+ *
+ * Chains of nodes with only one child are merged into a single edge, whose
+ * characters are compared all at once. Nodes are numbered breadth first, so
+ * the children of a node are adjacent, and they're sorted by the first
+ * character of their edge. These characters are stored in their own array, so
+ * finding the child to follow usually reads a single cache line.
+ */
 template <class Enum>
-struct from_chars_helper {
-    constexpr static view<map_entry<std::string_view, Enum>>
-    sorted_names_and_values() {
-        return view {enum_traits<Enum>::names_to_values.entries};
+struct name_trie {
+    constexpr static size_t size = num_states<Enum>;
+    constexpr static size_t num_nodes = trie_builder_v<Enum>.num_edges;
+    using block_type = typename enum_name_list<Enum>::block_type;
+    using index_type = uint_fit_t<
+        (num_nodes > block_type::block_size() ? num_nodes
+                                              : block_type::block_size())>;
+    using node_type = trie_node<index_type>;
+
+    // The first character of the edge leading to each node. The root's
+    // character is unused
+    std::array<unsigned char, num_nodes> labels {};
+    std::array<node_type, num_nodes> nodes {};
+
+    constexpr name_trie() {
+        auto const& builder = trie_builder_v<Enum>;
+        auto const& block = enum_name_list<Enum>::get_name_block();
+        // queue[i] is the first node in the builder's trie that was merged
+        // into node i
+        std::array<size_t, num_nodes> queue {};
+        size_t tail = 1;
+        for (size_t head = 0; head < num_nodes; head++) {
+            size_t first = queue[head];
+            size_t last = first;
+            while (last != 0 && !builder.ends_edge(last)) {
+                last++;
+            }
+            node_type& node = nodes[head];
+            node.first_child = index_type(tail);
+            node.ordinal = index_type(builder.ordinals[last]);
+            if (head != 0) {
+                node.edge_offset = index_type(builder.block_offsets[first]);
+                node.edge_size = index_type(last - first + 1);
+                labels[head] = (unsigned char)block.data[node.edge_offset];
+            }
+            size_t child = builder.first_child(last);
+            while (child != 0) {
+                queue[tail++] = child;
+                node.num_children++;
+                child = builder.next_sibling[child];
+            }
+        }
+    }
+
+    /**
+     * @brief Find the longest name that's a prefix of str
+     *
+     * @return prefix_match the ordinal and size of the name. The ordinal is
+     * num_states<Enum> if no name is a prefix of str
+     */
+    constexpr prefix_match longest_prefix(
+        std::string_view str) const noexcept {
+        char const* block = enum_name_list<Enum>::get_name_block().data;
+        prefix_match match {nodes[0].ordinal, 0};
+        size_t node = 0;
+        size_t i = 0;
+        while (i < str.size()) {
+            unsigned char ch = (unsigned char)str[i];
+            size_t child = nodes[node].first_child;
+            size_t end = child + nodes[node].num_children;
+            while (child < end && labels[child] < ch) {
+                child++;
+            }
+            if (child == end || labels[child] != ch) {
+                break;
+            }
+            // The first character of the edge was already compared. Names
+            // only end at the end of an edge, so if the rest of the edge
+            // doesn't match, there's no longer match
+            node = child;
+            size_t edge_size = nodes[node].edge_size;
+            if (str.size() - i < edge_size
+                || !equal_chars(
+                    str.substr(i + 1, edge_size - 1),
+                    block + nodes[node].edge_offset + 1)) {
+                break;
+            }
+            i += edge_size;
+            if (nodes[node].ordinal != size) {
+                match = {nodes[node].ordinal, i};
+            }
+        }
+        return match;
     }
 };
+
+template <class Enum>
+constexpr name_trie<Enum> name_trie_v {};
+
+// Copies str to [first, last). Returns the end of the copy, or nullptr if str
+// doesn't fit (or if first is already nullptr). Uses memcpy outside of
+// constant evaluation
+constexpr char* copy_chars(
+    char* first,
+    char* last,
+    std::string_view str) noexcept {
+    if (first == nullptr || size_t(last - first) < str.size()) {
+        return nullptr;
+    }
+    if (is_constant_evaluated()) {
+        for (size_t i = 0; i < str.size(); i++) {
+            first[i] = str[i];
+        }
+    } else if (str.size() > 0) {
+        std::memcpy(first, str.data(), str.size());
+    }
+    return first + str.size();
+}
+
+// Writes an integer in base 10. This is std::to_chars, except during constant
+// evaluation, since std::to_chars isn't constexpr before C++23
+template <class T>
+constexpr std::to_chars_result integer_to_chars(
+    char* first,
+    char* last,
+    T value) noexcept {
+    if (!is_constant_evaluated()) {
+        return std::to_chars(first, last, value);
+    }
+    using unsigned_type = std::make_unsigned_t<T>;
+    bool negative = false;
+    if constexpr (std::is_signed_v<T>) {
+        negative = value < 0;
+    }
+    unsigned_type magnitude = negative ? unsigned_type(0) - unsigned_type(value)
+                                       : unsigned_type(value);
+    char digits[3 * sizeof(T)] {};
+    size_t count = 0;
+    do {
+        digits[count++] = char('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (size_t(last - first) < count + negative) {
+        return {last, std::errc::value_too_large};
+    }
+    if (negative) {
+        *first++ = '-';
+    }
+    while (count > 0) {
+        *first++ = digits[--count];
+    }
+    return {first, std::errc {}};
+}
 } // namespace nav::detail
 namespace nav {
+/**
+ * @brief Parse the longest name of an enum that's a prefix of [first, last).
+ * The name doesn't need to be followed by a delimiter, so this can be used to
+ * tokenize text where names are immediately followed by other text.
+ *
+ * For flag enums, further names may follow, separated by '|' (eg,
+ * "Read|Write"), and the value is the union of their flags. Parsing stops
+ * before a '|' that isn't followed by a name.
+ *
+ * @param first the start of the input
+ * @param last the end of the input
+ * @param value set to the value of the name, if a name was found
+ * @return std::from_chars_result {end of the name, std::errc {}} on success,
+ * and {first, std::errc::invalid_argument} if no name is a prefix of the input
+ */
 template <class Enum>
-std::from_chars_result from_chars(
+constexpr std::from_chars_result from_chars(
     char const* first,
     char const* last,
-    Enum& value) {
-    constexpr auto get_key =
-        [](map_entry<std::string_view, Enum> const& entry) {
-            return entry->key;
-        };
-    constexpr auto names_and_values = view {
-        detail::from_chars_helper<Enum>::sorted_names_and_values()};
-
-    using traits = enum_traits<Enum>;
-
-    map_entry<std::string_view, Enum> const* id = find_longest_prefix(
-        names_and_values,
-        std::string_view(first, last - first),
-        get_key);
-    if (id) {
-        auto name = id->key;
-        value = id->value;
-        return std::from_chars_result {first + name.size(), std::errc {}};
-    } else {
+    Enum& value) noexcept {
+    auto const& trie = detail::name_trie_v<Enum>;
+    auto match = trie.longest_prefix(std::string_view(first, last - first));
+    if (match.ordinal >= num_states<Enum>) {
         return std::from_chars_result {first, std::errc::invalid_argument};
     }
+    char const* ptr = first + match.size;
+    if constexpr (is_flag_enum<Enum>) {
+        using unsigned_type = typename detail::flag_index<Enum>::unsigned_type;
+        auto bits = unsigned_type(enum_values<Enum>[match.ordinal]);
+        while (ptr != last && *ptr == '|') {
+            match = trie.longest_prefix(
+                std::string_view(ptr + 1, last - ptr - 1));
+            if (match.ordinal >= num_states<Enum>) {
+                break;
+            }
+            bits |= unsigned_type(enum_values<Enum>[match.ordinal]);
+            ptr += 1 + match.size;
+        }
+        value = Enum(bits);
+    } else {
+        value = enum_values<Enum>[match.ordinal];
+    }
+    return std::from_chars_result {ptr, std::errc {}};
+}
+
+/**
+ * @brief Controls how nav::to_chars writes the name of a value
+ */
+enum class name_style : char {
+    // Just the name of the value (eg, "North")
+    bare,
+    // The name of the value, with the enum type attached (eg,
+    // "Direction::North")
+    qualified,
+    // The name of the value, with the enum type and namespace attached (eg,
+    // "my_project::Direction::North")
+    full,
+};
+
+/**
+ * @brief Write the name of a value to [first, last). The name is copied out of
+ * the enum's name block, so nothing is allocated. Values without a name are
+ * written as their underlying integer, in the form "5" for bare names, and
+ * "Direction(5)" otherwise. This can be used in constant expressions.
+ *
+ * For flag enums, a value without a name of its own is written as the names of
+ * its flags, separated by '|' (eg, "Read|Write", or
+ * "Access::Read|Access::Write" with the type attached). It's only written as
+ * an integer if some of its bits have no name.
+ *
+ * @param first the start of the output buffer
+ * @param last the end of the output buffer
+ * @param value the value to write
+ * @param style whether to attach the enum type to the name
+ * @return std::to_chars_result {end of output, std::errc {}} on success, and
+ * {last, std::errc::value_too_large} if the output doesn't fit
+ */
+template <class Enum, class = std::enable_if_t<std::is_enum_v<Enum>>>
+constexpr std::to_chars_result to_chars(
+    char* first,
+    char* last,
+    Enum value,
+    name_style style = name_style::bare) noexcept {
+    using base_type = std::underlying_type_t<Enum>;
+    std::string_view type_name = style == name_style::full
+                                   ? enum_type_info<Enum>::qualified_type_name
+                                   : enum_type_info<Enum>::type_name;
+    std::string_view name;
+    bool has_name = name_of(value, name);
+
+    // copy_chars returns nullptr once the output doesn't fit, and passes
+    // nullptr through, so we only need to check at the end
+    char* ptr = first;
+    bool has_flag_names = false;
+    if constexpr (is_flag_enum<Enum>) {
+        if (!has_name) {
+            has_flag_names = detail::for_each_flag_bit_name(
+                value,
+                [&](std::string_view flag) {
+                    if (ptr != first) {
+                        ptr = detail::copy_chars(ptr, last, "|");
+                    }
+                    if (style != name_style::bare) {
+                        ptr = detail::copy_chars(ptr, last, type_name);
+                        ptr = detail::copy_chars(ptr, last, "::");
+                    }
+                    ptr = detail::copy_chars(ptr, last, flag);
+                });
+        }
+    }
+    if (has_flag_names) {
+        // The names of the flags were written above
+    } else if (has_name) {
+        if (style != name_style::bare) {
+            ptr = detail::copy_chars(ptr, last, type_name);
+            ptr = detail::copy_chars(ptr, last, "::");
+        }
+        ptr = detail::copy_chars(ptr, last, name);
+    } else {
+        if (style != name_style::bare) {
+            ptr = detail::copy_chars(ptr, last, type_name);
+            ptr = detail::copy_chars(ptr, last, "(");
+        }
+        if (ptr) {
+            auto result = detail::integer_to_chars(ptr, last, base_type(value));
+            ptr = result.ec == std::errc {} ? result.ptr : nullptr;
+        }
+        if (style != name_style::bare) {
+            ptr = detail::copy_chars(ptr, last, ")");
+        }
+    }
+    if (ptr) {
+        return {ptr, std::errc {}};
+    } else {
+        return {last, std::errc::value_too_large};
+    }
 }
 } // namespace nav
@@ -0,0 +1,378 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <nav/nav_core.hpp>
+#include <string_view>
+#include <type_traits>
+
+namespace nav::detail {
+// The ordinals of the first name declared for each value, in declaration
+// order. enum_map and enum_set only use these slots, so iterating over them
+// visits each value once, even if it has several names. The same ordinals are
+// also kept as a bitmask, in the layout used by enum_set.
+template <class Enum>
+struct unique_ordinals {
+    using ordinal_type = typename value_index_info<Enum>::ordinal_type;
+    size_t size = 0;
+    std::array<ordinal_type, num_states<Enum>> ordinals {};
+    std::array<uint64_t, (num_states<Enum> + 63) / 64> bits {};
+
+    constexpr unique_ordinals() {
+        for (size_t i = 0; i < num_states<Enum>; i++) {
+            if (ordinal_of(enum_values<Enum>[i]) == i) {
+                ordinals[size++] = ordinal_type(i);
+                bits[i / 64] |= uint64_t(1) << (i % 64);
+            }
+        }
+    }
+};
+
+template <class Enum>
+constexpr unique_ordinals<Enum> unique_ordinals_v {};
+} // namespace nav::detail
+
+namespace nav {
+/**
+ * @brief A set of values of an enum, stored as a bitset with one bit per
+ * ordinal. Inserting, erasing, and testing a value costs one call to
+ * nav::ordinal_of plus one bit operation, and the set never allocates.
+ * Iterating visits the values in the set in declaration order.
+ *
+ * @tparam Enum the enumeration type
+ */
+template <class Enum>
+class enum_set {
+   public:
+    constexpr static size_t num_words = (num_states<Enum> + 63) / 64;
+
+   private:
+    std::array<uint64_t, num_words> words {};
+
+    constexpr bool test_ordinal(size_t i) const noexcept {
+        return (words[i / 64] >> (i % 64)) & 1;
+    }
+
+   public:
+    // Iterates over the ordinals of the set bits. Reference is either Enum,
+    // to yield values, or enum_entry<Enum>, to yield names and values
+    template <class Reference>
+    class basic_iterator {
+        uint64_t const* words {};
+        size_t ordinal {};
+
+        constexpr void skip_to_set_bit() noexcept {
+            while (ordinal < num_states<Enum>) {
+                uint64_t bits = words[ordinal / 64] >> (ordinal % 64);
+                if (bits != 0) {
+                    ordinal += size_t(detail::countr_zero(bits));
+                    return;
+                }
+                ordinal = (ordinal / 64 + 1) * 64;
+            }
+            ordinal = num_states<Enum>;
+        }
+
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Reference;
+        using difference_type = std::ptrdiff_t;
+        using reference = Reference;
+        using pointer = void;
+
+        basic_iterator() = default;
+        constexpr basic_iterator(uint64_t const* words, size_t ordinal) noexcept
+          : words(words)
+          , ordinal(ordinal) {
+            skip_to_set_bit();
+        }
+
+        constexpr Reference operator*() const noexcept {
+            if constexpr (std::is_same_v<Reference, Enum>) {
+                return enum_values<Enum>[ordinal];
+            } else {
+                return {enum_names<Enum>[ordinal], enum_values<Enum>[ordinal]};
+            }
+        }
+        constexpr basic_iterator& operator++() noexcept {
+            ordinal++;
+            skip_to_set_bit();
+            return *this;
+        }
+        constexpr basic_iterator operator++(int) noexcept {
+            basic_iterator previous_state = *this;
+            ++*this;
+            return previous_state;
+        }
+        constexpr bool operator==(basic_iterator const& other) const noexcept {
+            return ordinal == other.ordinal;
+        }
+        constexpr bool operator!=(basic_iterator const& other) const noexcept {
+            return ordinal != other.ordinal;
+        }
+    };
+    using iterator = basic_iterator<Enum>;
+    using const_iterator = iterator;
+    using entry_iterator = basic_iterator<enum_entry<Enum>>;
+
+    // The names and values in a set, as returned by enum_set::entries(). This
+    // holds a copy of the set's bits, so it can be used to iterate over a
+    // temporary set
+    struct entry_range {
+        std::array<uint64_t, num_words> words {};
+        constexpr entry_iterator begin() const noexcept {
+            return entry_iterator(words.data(), 0);
+        }
+        constexpr entry_iterator end() const noexcept {
+            return entry_iterator(words.data(), num_states<Enum>);
+        }
+    };
+
+    constexpr enum_set() = default;
+    constexpr enum_set(std::initializer_list<Enum> values) noexcept {
+        for (Enum value : values) {
+            insert(value);
+        }
+    }
+
+    // Returns false if the value was already in the set, or has no name
+    constexpr bool insert(Enum value) noexcept {
+        size_t i = ordinal_of(value);
+        if (i >= num_states<Enum> || test_ordinal(i)) {
+            return false;
+        }
+        words[i / 64] |= uint64_t(1) << (i % 64);
+        return true;
+    }
+    // Returns false if the value wasn't in the set
+    constexpr bool erase(Enum value) noexcept {
+        size_t i = ordinal_of(value);
+        if (i >= num_states<Enum> || !test_ordinal(i)) {
+            return false;
+        }
+        words[i / 64] &= ~(uint64_t(1) << (i % 64));
+        return true;
+    }
+    constexpr bool contains(Enum value) const noexcept {
+        size_t i = ordinal_of(value);
+        return i < num_states<Enum> && test_ordinal(i);
+    }
+    constexpr void clear() noexcept {
+        words = {};
+    }
+
+    constexpr size_t size() const noexcept {
+        size_t count = 0;
+        for (uint64_t word : words) {
+            count += size_t(detail::popcount(word));
+        }
+        return count;
+    }
+    constexpr bool empty() const noexcept {
+        for (uint64_t word : words) {
+            if (word != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // The bits of the set. Bit i % 64 of word i / 64 is set if the value with
+    // ordinal i is in the set
+    constexpr std::array<uint64_t, num_words> const& bits() const noexcept {
+        return words;
+    }
+    // Makes a set from bits in the layout given by bits(). Bits which don't
+    // belong to a value, either past the last ordinal or at the ordinal of an
+    // alias, are ignored
+    constexpr static enum_set from_bits(
+        std::array<uint64_t, num_words> const& bits) noexcept {
+        auto const& mask = detail::unique_ordinals_v<Enum>.bits;
+        enum_set result;
+        for (size_t i = 0; i < num_words; i++) {
+            result.words[i] = bits[i] & mask[i];
+        }
+        return result;
+    }
+
+    constexpr iterator begin() const noexcept {
+        return iterator(words.data(), 0);
+    }
+    constexpr iterator end() const noexcept {
+        return iterator(words.data(), num_states<Enum>);
+    }
+    // Iterates over the name and value of each value in the set, in
+    // declaration order
+    constexpr entry_range entries() const noexcept {
+        return {words};
+    }
+
+    constexpr enum_set& operator|=(enum_set const& other) noexcept {
+        for (size_t i = 0; i < num_words; i++) {
+            words[i] |= other.words[i];
+        }
+        return *this;
+    }
+    constexpr enum_set& operator&=(enum_set const& other) noexcept {
+        for (size_t i = 0; i < num_words; i++) {
+            words[i] &= other.words[i];
+        }
+        return *this;
+    }
+    // Removes the values in other from this set
+    constexpr enum_set& operator-=(enum_set const& other) noexcept {
+        for (size_t i = 0; i < num_words; i++) {
+            words[i] &= ~other.words[i];
+        }
+        return *this;
+    }
+    constexpr friend enum_set operator|(enum_set a, enum_set const& b) {
+        return a |= b;
+    }
+    constexpr friend enum_set operator&(enum_set a, enum_set const& b) {
+        return a &= b;
+    }
+    constexpr friend enum_set operator-(enum_set a, enum_set const& b) {
+        return a -= b;
+    }
+    constexpr bool operator==(enum_set const& other) const noexcept {
+        for (size_t i = 0; i < num_words; i++) {
+            if (words[i] != other.words[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+    constexpr bool operator!=(enum_set const& other) const noexcept {
+        return !(*this == other);
+    }
+};
+
+// An element of an enum_map, as seen when iterating over it
+template <class Enum, class Ref>
+struct enum_map_entry {
+    Enum value {};
+    std::string_view name;
+    Ref mapped;
+};
+
+/**
+ * @brief A map from the values of an enum to T, stored as an array with one
+ * element per ordinal. Looking up a value costs one call to nav::ordinal_of
+ * and one index into the array, and the map never allocates. Every value
+ * declared in the enum is always present, starting out as T().
+ *
+ * Iterating yields an enum_map_entry with the value, its name, and a reference
+ * to its element, in declaration order. If several names were declared for
+ * the same value, they share the element of the first name, which is the only
+ * one visited.
+ *
+ * @tparam Enum the enumeration type
+ * @tparam T the type of the elements
+ */
+template <class Enum, class T>
+class enum_map {
+    std::array<T, num_states<Enum>> elements {};
+
+   public:
+    template <class Ref>
+    class basic_iterator {
+        using ordinal_type =
+            typename detail::unique_ordinals<Enum>::ordinal_type;
+        using element_pointer = std::remove_reference_t<Ref>*;
+        ordinal_type const* current {};
+        element_pointer elements {};
+
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = enum_map_entry<Enum, Ref>;
+        using difference_type = std::ptrdiff_t;
+        using reference = enum_map_entry<Enum, Ref>;
+        using pointer = void;
+
+        basic_iterator() = default;
+        constexpr basic_iterator(
+            ordinal_type const* current,
+            element_pointer elements) noexcept
+          : current(current)
+          , elements(elements) {}
+
+        constexpr reference operator*() const noexcept {
+            size_t i = *current;
+            return {enum_values<Enum>[i], enum_names<Enum>[i], elements[i]};
+        }
+        constexpr basic_iterator& operator++() noexcept {
+            current++;
+            return *this;
+        }
+        constexpr basic_iterator operator++(int) noexcept {
+            basic_iterator previous_state = *this;
+            current++;
+            return previous_state;
+        }
+        constexpr bool operator==(basic_iterator const& other) const noexcept {
+            return current == other.current;
+        }
+        constexpr bool operator!=(basic_iterator const& other) const noexcept {
+            return current != other.current;
+        }
+    };
+    using iterator = basic_iterator<T&>;
+    using const_iterator = basic_iterator<T const&>;
+
+    constexpr enum_map() = default;
+    // Initializes every element to value
+    constexpr explicit enum_map(T const& value) {
+        for (T& element : elements) {
+            element = value;
+        }
+    }
+
+    // The value must have a name. Use find for values which may not
+    constexpr T& operator[](Enum value) noexcept {
+        return elements[ordinal_of(value)];
+    }
+    constexpr T const& operator[](Enum value) const noexcept {
+        return elements[ordinal_of(value)];
+    }
+    // Returns nullptr if the value has no name
+    constexpr T* find(Enum value) noexcept {
+        size_t i = ordinal_of(value);
+        return i < num_states<Enum> ? &elements[i] : nullptr;
+    }
+    constexpr T const* find(Enum value) const noexcept {
+        size_t i = ordinal_of(value);
+        return i < num_states<Enum> ? &elements[i] : nullptr;
+    }
+    constexpr bool contains(Enum value) const noexcept {
+        return ordinal_of(value) < num_states<Enum>;
+    }
+
+    // The number of distinct values in the enum
+    constexpr static size_t size() noexcept {
+        return detail::unique_ordinals_v<Enum>.size;
+    }
+    constexpr static bool empty() noexcept {
+        return size() == 0;
+    }
+
+    constexpr iterator begin() noexcept {
+        return iterator(ordinals(), elements.data());
+    }
+    constexpr iterator end() noexcept {
+        return iterator(ordinals() + size(), elements.data());
+    }
+    constexpr const_iterator begin() const noexcept {
+        return const_iterator(ordinals(), elements.data());
+    }
+    constexpr const_iterator end() const noexcept {
+        return const_iterator(ordinals() + size(), elements.data());
+    }
+
+   private:
+    constexpr static auto ordinals() noexcept {
+        return detail::unique_ordinals_v<Enum>.ordinals.data();
+    }
+};
+} // namespace nav
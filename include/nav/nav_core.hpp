@@ -2,14 +2,17 @@
 #define NAV_NAV_CORE
 
 #include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <optional>
 #include <string_view>
+#include <type_traits>
 
 #ifndef NAV_ADD_NULL_TERMINATORS
 #define NAV_ADD_NULL_TERMINATORS 0
 #endif
 
-// TODO: Add function declarations + rewrite in terms of function declarations
 namespace nav {
 /**
  * @brief Return the declared name of a value in an enumeration, and store it in
@@ -74,6 +77,33 @@ template <class Enum>
 constexpr auto value_of(
     std::string_view name,
     bool ignore_case = false) noexcept -> std::optional<Enum>;
+
+/**
+ * @brief Get the ordinal of a value: its index in `enum_values` and
+ * `enum_names`. If several names were declared for the value, this is the
+ * ordinal of the first one. Lookups take O(1) time for compact enumerations.
+ *
+ * @tparam Enum the enumeration type
+ * @param value the value
+ * @return the ordinal of the value, or `num_states<Enum>` if it has no name
+ */
+template <class Enum>
+constexpr size_t ordinal_of(Enum value) noexcept;
+
+/**
+ * @brief Call `fn` with the name of each flag set in a value, in order of bit
+ * position. If the value has a name of its own (such as `None = 0` or
+ * `All = A | B | C`), `fn` is only called with that name. If any set bit has no
+ * name, returns false without calling `fn`.
+ *
+ * @tparam Enum the enumeration type, declared with NAV_DECLARE_FLAG_ENUM
+ * @param value the value whose flags should be named
+ * @param fn a function with the signature (std::string_view) -> void
+ * @return true on success
+ * @return false if the value can't be written as a list of names
+ */
+template <class Enum, class Fn>
+constexpr bool for_each_flag_name(Enum value, Fn&& fn);
 } // namespace nav
 
 // Functions to get the name of a type at compile time
@@ -193,73 +223,90 @@ struct enum_maker {
     }
 };
 
+// Holds the value of one enumerator. These are constructed in an array, one
+// per enumerator, in the order the enumerators are declared:
+//
+//     enum_value_slot<int> slots[] {enum_value_slot<int>(), A, B = 10, C};
+//
+// The first slot comes before any of the enumerators. An enumerator that
+// wasn't given a value takes the one after the value in the previous slot, and
+// the enumerator is updated so that later initializers (eg, D = C + 1) see it.
+//
+// The initializers of an array aren't nested in one another, which compilers
+// handle in linear time. A chain of calls to operator, is nested, and with
+// optimizations enabled, compilers take time quadratic in its length to fold it
 template <class BaseT>
-struct value_assigner {
+struct enum_value_slot {
     BaseT value {};
+    bool has_value = false;
 
-    constexpr value_assigner& operator,(enum_maker<BaseT>& other) {
-        if (other.is_set) {
-            // Update the current value to be the one stored in the enum
-            value = other.value;
-        } else {
-            // set the enum value to be the current value
-            other = value;
+    enum_value_slot() = default;
+    constexpr enum_value_slot(enum_maker<BaseT>& maker) {
+        // The slot before this one was constructed first
+        enum_value_slot const& previous = this[-1];
+        if (!maker.is_set) {
+            maker = previous.has_value ? BaseT(previous.value + 1) : BaseT();
         }
-        // Also we increment the value we hold
-        value++;
-        return *this;
+        value = maker.value;
+        has_value = true;
     }
 };
 
-constexpr std::string_view trim_whitespace(std::string_view view) {
-    size_t start = view.find_first_not_of(' ');
-    if (start == std::string_view::npos) {
-        return "";
-    } else {
-        size_t end = view.find_first_of(" =", start);
-        if (end == std::string_view::npos) {
-            return view.substr(start);
-        } else {
-            return view.substr(start, end - start);
-        }
-    }
-}
-template <size_t N, size_t StrSize, class Fn>
+// Calls func with each name in a stringized list of enumerators, such as
+// "A, B = 10, C". The name is everything up to the first space or '=' in each
+// entry.
+//
+// This indexes the characters directly. Compilers evaluate string_view
+// searches (find_first_of in particular) very slowly in constant expressions,
+// and for enums with thousands of members that dominated compile times
+template <size_t StrSize, class Fn>
 constexpr void split_trim_apply(char const (&str)[StrSize], Fn func) {
-    std::string_view view(str, StrSize - 1);
-
-    for (size_t i = 0; i < N; i++) {
-        auto new_pos = view.find(',');
-        func(trim_whitespace(view.substr(0, new_pos)));
-        if (new_pos != std::string_view::npos) {
-            view = view.substr(new_pos + 1);
-        } else {
-            break;
+    constexpr size_t size = StrSize - 1;
+    size_t i = 0;
+    while (i < size) {
+        while (i < size && str[i] == ' ') {
+            i++;
+        }
+        size_t start = i;
+        while (i < size && str[i] != ' ' && str[i] != '=' && str[i] != ',') {
+            i++;
+        }
+        if (i > start) {
+            func(std::string_view(str + start, i - start));
         }
+        // Skip the initializer, if any
+        while (i < size && str[i] != ',') {
+            i++;
+        }
+        i++;
     }
 }
-template <size_t N, size_t StrSize>
-constexpr size_t compute_name_block_size(char const (&str)[StrSize]) {
-    size_t total = 0;
-    split_trim_apply<N>(str, [&](std::string_view sv) { total += sv.size(); });
-// The name block size is the total count + N, because each name is null
-// terminated.
-#if NAV_ADD_NULL_TERMINATORS
-    return total + N;
-#else
-    return total;
-#endif
+// The number of names in a stringized list of enumerators, and the size of the
+// block needed to hold them
+struct name_layout {
+    size_t num_names = 0;
+    size_t block_size = 0;
+};
+template <size_t StrSize>
+constexpr name_layout get_name_layout(char const (&str)[StrSize]) {
+    name_layout layout;
+    split_trim_apply(str, [&](std::string_view sv) {
+        layout.num_names++;
+        // Each name is followed by a null terminator, if those are enabled
+        layout.block_size += sv.size() + NAV_ADD_NULL_TERMINATORS;
+    });
+    return layout;
 }
 // Copy characters into the destination buffer and store the offsets in the
 // offsets variable. Names are separated by a '\0' character for compatibility
 // with C.
-template <size_t N, size_t StrSize>
+template <size_t StrSize, class Offset>
 constexpr void write_names_and_sizes(
     char const (&str)[StrSize],
     char* dest,
-    unsigned* offsets) {
-    unsigned current_offset = 0;
-    split_trim_apply<N>(str, [&](std::string_view sv) {
+    Offset* offsets) {
+    Offset current_offset = 0;
+    split_trim_apply(str, [&](std::string_view sv) {
         char const* source = sv.data();
         size_t size = sv.size();
         for (size_t i = 0; i < size; i++) {
@@ -291,19 +338,30 @@ template <size_t N>
 constexpr auto get_top_name(char const (&str)[N]) {
     return get_top_name(std::string_view(str, N - 1));
 }
+
+// The smallest unsigned integer type capable of holding MaxValue
+template <uint64_t MaxValue>
+using uint_fit_t = std::conditional_t<
+    MaxValue <= 0xff,
+    uint8_t,
+    std::conditional_t<
+        MaxValue <= 0xffff,
+        uint16_t,
+        std::conditional_t<MaxValue <= 0xffffffff, uint32_t, uint64_t>>>;
 } // namespace nav::detail
 
 namespace nav {
+template <class Offset>
 class string_block_iterator {
     char const* data {};
-    unsigned const* indices {};
+    Offset const* indices {};
 
    public:
     string_block_iterator() = default;
     string_block_iterator(string_block_iterator const&) = default;
     constexpr string_block_iterator(
         char const* data,
-        unsigned const* indices) noexcept
+        Offset const* indices) noexcept
       : data(data)
       , indices(indices) {}
 
@@ -345,8 +403,12 @@ struct string_block {
         BlockSize >= N,
         "The size of the block must be greater than or equal to the number of "
         "strings");
+    // Offsets are stored in the smallest type that can hold the size of the
+    // block, so most enums use one or two bytes per name
+    using offset_type = detail::uint_fit_t<BlockSize>;
+
     char data[BlockSize] {};
-    unsigned offsets[N + 1] {};
+    offset_type offsets[N + 1] {};
     string_block() = default;
     string_block(string_block const&) = default;
 
@@ -375,7 +437,7 @@ struct string_block {
         func(source, *this);
     }
 
-    using iterator = string_block_iterator;
+    using iterator = string_block_iterator<offset_type>;
     using const_iterator = iterator;
     constexpr iterator begin() const noexcept {
         return iterator(data, offsets);
@@ -410,6 +472,7 @@ struct enum_type_info_base {
         get_top_name(name_of_type<Enum>)};
     constexpr static size_t num_states = 0;
     constexpr static bool is_nav_enum = false;
+    constexpr static bool is_flag_enum = false;
     constexpr static size_t size() noexcept {
         return 0;
     }
@@ -436,6 +499,7 @@ struct enum_type_info : public detail::enum_type_info_base<Enum> {
     using super = detail::enum_type_info_base<Enum>;
 
    public:
+    using super::is_flag_enum;
     using super::is_nav_enum;
     using super::num_states;
     using super::qualified_type_name;
@@ -469,7 +533,7 @@ struct enum_name_list : enum_type_info<Enum> {
 
    public:
     using block_type = typename detail::enum_name_list_base<Enum>::block_type;
-    using iterator = string_block_iterator;
+    using iterator = typename block_type::iterator;
     using const_iterator = iterator;
     constexpr static block_type const& get_name_block() noexcept {
         return name_info.name_block;
@@ -488,6 +552,15 @@ struct enum_name_list : enum_type_info<Enum> {
 template <class Enum>
 constexpr bool is_nav_enum = enum_type_info<Enum>::is_nav_enum;
 
+// True for enums declared with NAV_DECLARE_FLAG_ENUM
+template <class Enum>
+constexpr bool is_flag_enum = enum_type_info<Enum>::is_flag_enum;
+
+#if __cpp_concepts >= 201907L
+template <class T>
+concept nav_enum = is_nav_enum<T>;
+#endif
+
 template <class Enum>
 constexpr size_t num_states = enum_type_info<Enum>::num_states;
 
@@ -498,7 +571,949 @@ template <class Enum>
 constexpr enum_name_list<Enum> enum_names {};
 } // namespace nav
 
-#define NAV_DECLARE_ENUM(EnumType, BaseType, ...)                              \
+namespace nav::detail {
+// True for flag enums. Only enums are checked with is_flag_enum, so that the
+// operators below are cheap to rule out for other types
+template <class T, bool = std::is_enum_v<T>>
+constexpr bool has_flag_operators = false;
+template <class T>
+constexpr bool has_flag_operators<T, true> = is_flag_enum<T>;
+template <class T>
+using enable_if_flag_enum = std::enable_if_t<has_flag_operators<T>>;
+} // namespace nav::detail
+
+// Bitwise operators for flag enums. They're found through the using
+// declarations written by NAV_DECLARE_FLAG_OPERATORS
+namespace nav::flag_operators {
+template <class Enum, class = detail::enable_if_flag_enum<Enum>>
+constexpr Enum operator~(Enum a) noexcept {
+    using base_type = std::underlying_type_t<Enum>;
+    return Enum(~base_type(a));
+}
+template <class Enum, class = detail::enable_if_flag_enum<Enum>>
+constexpr Enum operator|(Enum a, Enum b) noexcept {
+    using base_type = std::underlying_type_t<Enum>;
+    return Enum(base_type(a) | base_type(b));
+}
+template <class Enum, class = detail::enable_if_flag_enum<Enum>>
+constexpr Enum operator&(Enum a, Enum b) noexcept {
+    using base_type = std::underlying_type_t<Enum>;
+    return Enum(base_type(a) & base_type(b));
+}
+template <class Enum, class = detail::enable_if_flag_enum<Enum>>
+constexpr Enum operator^(Enum a, Enum b) noexcept {
+    using base_type = std::underlying_type_t<Enum>;
+    return Enum(base_type(a) ^ base_type(b));
+}
+template <class Enum, class = detail::enable_if_flag_enum<Enum>>
+constexpr Enum& operator|=(Enum& a, Enum b) noexcept {
+    return a = a | b;
+}
+template <class Enum, class = detail::enable_if_flag_enum<Enum>>
+constexpr Enum& operator&=(Enum& a, Enum b) noexcept {
+    return a = a & b;
+}
+template <class Enum, class = detail::enable_if_flag_enum<Enum>>
+constexpr Enum& operator^=(Enum& a, Enum b) noexcept {
+    return a = a ^ b;
+}
+} // namespace nav::flag_operators
+
+namespace nav {
+// The name and value of one enumerator, as given by nav::enum_entries
+template <class Enum>
+struct enum_entry {
+    std::string_view name;
+    Enum value {};
+};
+} // namespace nav
+
+namespace nav::detail {
+// The value of each enumerator, stored next to the position and size of its
+// name in the enum's name block. Iterating over the entries reads this one
+// array, plus the names themselves.
+template <class Enum>
+struct entry_table {
+    using block_type = typename enum_name_list<Enum>::block_type;
+    using offset_type = typename block_type::offset_type;
+    struct record {
+        Enum value {};
+        offset_type offset {};
+        offset_type size {};
+    };
+    std::array<record, num_states<Enum>> records {};
+
+    constexpr entry_table() {
+        auto const& block = enum_name_list<Enum>::get_name_block();
+        for (size_t i = 0; i < records.size(); i++) {
+            records[i].value = enum_values<Enum>[i];
+            records[i].offset = block.offsets[i];
+            records[i].size = offset_type(
+                block.offsets[i + 1] - block.offsets[i]
+                - NAV_ADD_NULL_TERMINATORS);
+        }
+    }
+};
+
+template <class Enum>
+constexpr entry_table<Enum> entry_table_v {};
+} // namespace nav::detail
+
+namespace nav {
+template <class Enum>
+class enum_entry_iterator {
+    using record = typename detail::entry_table<Enum>::record;
+    record const* current {};
+
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = enum_entry<Enum>;
+    using difference_type = std::ptrdiff_t;
+    using reference = enum_entry<Enum>;
+    using pointer = void;
+
+    enum_entry_iterator() = default;
+    enum_entry_iterator(enum_entry_iterator const&) = default;
+    constexpr explicit enum_entry_iterator(record const* current) noexcept
+      : current(current) {}
+
+    constexpr enum_entry<Enum> operator*() const noexcept {
+        char const* data = enum_name_list<Enum>::get_name_block().data;
+        return {
+            std::string_view(data + current->offset, current->size),
+            current->value};
+    }
+    constexpr enum_entry<Enum> operator[](difference_type i) const noexcept {
+        return *(*this + i);
+    }
+
+    constexpr enum_entry_iterator& operator++() noexcept {
+        current++;
+        return *this;
+    }
+    constexpr enum_entry_iterator operator++(int) noexcept {
+        enum_entry_iterator previous_state = *this;
+        current++;
+        return previous_state;
+    }
+    constexpr enum_entry_iterator& operator--() noexcept {
+        current--;
+        return *this;
+    }
+    constexpr enum_entry_iterator operator--(int) noexcept {
+        enum_entry_iterator previous_state = *this;
+        current--;
+        return previous_state;
+    }
+    constexpr enum_entry_iterator& operator+=(difference_type n) noexcept {
+        current += n;
+        return *this;
+    }
+    constexpr enum_entry_iterator& operator-=(difference_type n) noexcept {
+        current -= n;
+        return *this;
+    }
+    constexpr enum_entry_iterator operator+(difference_type n) const noexcept {
+        return enum_entry_iterator(current + n);
+    }
+    constexpr friend enum_entry_iterator operator+(
+        difference_type n,
+        enum_entry_iterator it) noexcept {
+        return it + n;
+    }
+    constexpr enum_entry_iterator operator-(difference_type n) const noexcept {
+        return enum_entry_iterator(current - n);
+    }
+    constexpr difference_type operator-(
+        enum_entry_iterator const& other) const noexcept {
+        return current - other.current;
+    }
+
+    constexpr bool operator==(
+        enum_entry_iterator const& other) const noexcept {
+        return current == other.current;
+    }
+    constexpr bool operator!=(
+        enum_entry_iterator const& other) const noexcept {
+        return current != other.current;
+    }
+    constexpr bool operator<(enum_entry_iterator const& other) const noexcept {
+        return current < other.current;
+    }
+    constexpr bool operator>(enum_entry_iterator const& other) const noexcept {
+        return current > other.current;
+    }
+    constexpr bool operator<=(
+        enum_entry_iterator const& other) const noexcept {
+        return current <= other.current;
+    }
+    constexpr bool operator>=(
+        enum_entry_iterator const& other) const noexcept {
+        return current >= other.current;
+    }
+};
+
+/**
+ * @brief A random-access range over the names and values of an enum, in the
+ * order they were declared. Use this instead of walking enum_names and
+ * enum_values side by side.
+ */
+template <class Enum>
+struct enum_entry_list : enum_type_info<Enum> {
+   private:
+    using super = enum_type_info<Enum>;
+
+   public:
+    using iterator = enum_entry_iterator<Enum>;
+    using const_iterator = iterator;
+    constexpr iterator begin() const noexcept {
+        return iterator(detail::entry_table_v<Enum>.records.data());
+    }
+    constexpr iterator end() const noexcept {
+        return begin() + super::num_states;
+    }
+    constexpr enum_entry<Enum> operator[](size_t i) const noexcept {
+        return begin()[i];
+    }
+};
+
+template <class Enum>
+constexpr enum_entry_list<Enum> enum_entries {};
+} // namespace nav
+
+namespace nav::detail {
+constexpr auto to_lower = [](char ch) -> char {
+    return 'A' <= ch && ch <= 'Z' ? ch - 'A' + 'a' : ch;
+};
+
+// Lowercase copy of an enum's name block. Shared by name_of and
+// nav::lowercase_enum_names, so there's at most one copy per enum.
+template <class Enum>
+constexpr typename enum_name_list<Enum>::block_type lowercase_name_block {
+    [](auto& dest) {
+        auto const& source = enum_name_list<Enum>::get_name_block();
+        for (size_t i = 0; i < source.block_size(); i++) {
+            dest.data[i] = to_lower(source.data[i]);
+        }
+        for (size_t i = 0; i <= source.size(); i++) {
+            dest.offsets[i] = source.offsets[i];
+        }
+    }};
+
+template <class Enum>
+constexpr auto to_underlying(Enum value) noexcept {
+    return std::underlying_type_t<Enum>(value);
+}
+
+// The index of the lowest set bit. bits must not be 0
+constexpr int countr_zero(uint64_t bits) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(bits);
+#else
+    int i = 0;
+    for (; (bits & 1) == 0; bits >>= 1) {
+        i++;
+    }
+    return i;
+#endif
+}
+
+// The number of set bits
+constexpr int popcount(uint64_t bits) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(bits);
+#else
+    int count = 0;
+    for (; bits != 0; bits &= bits - 1) {
+        count++;
+    }
+    return count;
+#endif
+}
+
+/**
+ * @brief Stably sort an array using a bottom-up merge sort. This avoids the
+ * recursive template instantiations of a top-down sort.
+ *
+ * @param values the array to sort
+ * @param less a function with the signature (T const&, T const&) -> bool
+ */
+template <class T, size_t N, class Less>
+constexpr void stable_sort(std::array<T, N>& values, Less less) {
+    std::array<T, N> buffer {};
+    T* source = values.data();
+    T* dest = buffer.data();
+    for (size_t width = 1; width < N; width *= 2) {
+        for (size_t start = 0; start < N; start += 2 * width) {
+            size_t mid = start + width < N ? start + width : N;
+            size_t end = mid + width < N ? mid + width : N;
+            size_t a = start, b = mid, out = start;
+            while (a < mid && b < end) {
+                dest[out++] = less(source[b], source[a]) ? source[b++]
+                                                         : source[a++];
+            }
+            while (a < mid) {
+                dest[out++] = source[a++];
+            }
+            while (b < end) {
+                dest[out++] = source[b++];
+            }
+        }
+        T* tmp = source;
+        source = dest;
+        dest = tmp;
+    }
+    if (source != values.data()) {
+        for (size_t i = 0; i < N; i++) {
+            values[i] = source[i];
+        }
+    }
+}
+
+// Compares two names, optionally ignoring the case of ascii characters
+template <bool IgnoreCase>
+constexpr int compare_names(std::string_view a, std::string_view b) noexcept {
+    if constexpr (IgnoreCase) {
+        size_t size = a.size() < b.size() ? a.size() : b.size();
+        for (size_t i = 0; i < size; i++) {
+            unsigned char ch_a = to_lower(a[i]);
+            unsigned char ch_b = to_lower(b[i]);
+            if (ch_a != ch_b) {
+                return ch_a < ch_b ? -1 : 1;
+            }
+        }
+        return a.size() == b.size() ? 0 : a.size() < b.size() ? -1 : 1;
+    } else {
+        return a.compare(b);
+    }
+}
+
+// Information used to pick a strategy for looking up values
+template <class Enum>
+struct value_index_info {
+    using base_type = std::underlying_type_t<Enum>;
+    using unsigned_type = std::make_unsigned_t<base_type>;
+    constexpr static size_t size = num_states<Enum>;
+    // Ordinals index into enum_values and enum_names. The value `size` is
+    // used to indicate that there is no corresponding ordinal.
+    using ordinal_type = uint_fit_t<size>;
+
+    constexpr static base_type get_min() noexcept {
+        base_type result = size > 0 ? base_type(enum_values<Enum>[0]) : 0;
+        for (Enum value : enum_values<Enum>) {
+            result = base_type(value) < result ? base_type(value) : result;
+        }
+        return result;
+    }
+    constexpr static base_type get_max() noexcept {
+        base_type result = size > 0 ? base_type(enum_values<Enum>[0]) : 0;
+        for (Enum value : enum_values<Enum>) {
+            result = base_type(value) > result ? base_type(value) : result;
+        }
+        return result;
+    }
+    constexpr static base_type min = get_min();
+    constexpr static base_type max = get_max();
+    // Computes value - min without the possibility of overflow
+    constexpr static unsigned_type offset_of(base_type value) noexcept {
+        return unsigned_type(unsigned_type(value) - unsigned_type(min));
+    }
+    // Computes b - a, where a <= b, without the possibility of overflow
+    constexpr static unsigned_type distance(base_type a, base_type b) noexcept {
+        return unsigned_type(unsigned_type(b) - unsigned_type(a));
+    }
+    constexpr static unsigned_type range = offset_of(max);
+    // Enums whose values fit in a small range are indexed directly (this is
+    // the same heuristic used by select_map)
+    constexpr static bool is_dense = size > 0 && range <= 2 * size + 256;
+};
+
+template <class Enum, bool Dense = value_index_info<Enum>::is_dense>
+struct value_index;
+
+// Maps values to ordinals in O(1) by indexing a table by value - min
+template <class Enum>
+struct value_index<Enum, true> : value_index_info<Enum> {
+    using info = value_index_info<Enum>;
+    using typename info::base_type;
+    using typename info::ordinal_type;
+    using typename info::unsigned_type;
+    std::array<ordinal_type, info::range + 1> ordinals {};
+
+    constexpr value_index() {
+        for (auto& ordinal : ordinals) {
+            ordinal = info::size;
+        }
+        // Iterate in reverse, so that aliased values get the ordinal of the
+        // first name declared for that value
+        for (size_t i = info::size; i-- > 0;) {
+            ordinals[info::offset_of(base_type(enum_values<Enum>[i]))] =
+                ordinal_type(i);
+        }
+    }
+    constexpr size_t find(Enum value) const noexcept {
+        unsigned_type i = info::offset_of(base_type(value));
+        return i <= info::range ? ordinals[i] : info::size;
+    }
+};
+
+// The unique values of an enum in ascending order, along with the ordinal of
+// the first name declared for each value. Used to build value_index for
+// sparse enums
+template <class Enum>
+struct sorted_values : value_index_info<Enum> {
+    using info = value_index_info<Enum>;
+    using typename info::base_type;
+    using typename info::ordinal_type;
+    std::array<base_type, info::size> values {};
+    std::array<ordinal_type, info::size> ordinals {};
+    size_t count = 0;
+
+    constexpr sorted_values() {
+        for (size_t i = 0; i < info::size; i++) {
+            ordinals[i] = ordinal_type(i);
+        }
+        stable_sort(ordinals, [](ordinal_type a, ordinal_type b) {
+            return base_type(enum_values<Enum>[a])
+                 < base_type(enum_values<Enum>[b]);
+        });
+        // The sort is stable, so the first of any aliased values is the one
+        // that was declared first
+        for (size_t i = 0; i < info::size; i++) {
+            base_type value = base_type(enum_values<Enum>[ordinals[i]]);
+            if (count == 0 || values[count - 1] != value) {
+                values[count] = value;
+                ordinals[count] = ordinals[i];
+                count++;
+            }
+        }
+    }
+};
+
+template <class Enum>
+constexpr sorted_values<Enum> sorted_values_v {};
+
+// The values of a sparse enum are split into runs, where each value is at most
+// max_run_gap more than the one before it. A run with at least min_run_size
+// values gets a table indexed by value, so that at least a quarter of the
+// table is used. Values in shorter runs are outliers.
+constexpr size_t max_run_gap = 4;
+constexpr size_t min_run_size = 4;
+
+// Calls fn(first, last) for each run in sorted_values_v<Enum>, where first and
+// last are the positions of the first and last value in the run
+template <class Enum, class Fn>
+constexpr void for_each_value_run(Fn&& fn) {
+    using info = value_index_info<Enum>;
+    auto const& sorted = sorted_values_v<Enum>;
+    size_t first = 0;
+    for (size_t i = 1; i <= sorted.count; i++) {
+        if (i == sorted.count
+            || info::distance(sorted.values[i - 1], sorted.values[i])
+                   > max_run_gap) {
+            fn(first, i - 1);
+            first = i;
+        }
+    }
+}
+
+struct value_run_layout {
+    size_t num_runs = 0;
+    // Total size of the tables for every run
+    size_t num_slots = 0;
+    size_t num_outliers = 0;
+};
+
+template <class Enum>
+constexpr auto get_value_run_layout() -> value_run_layout {
+    using info = value_index_info<Enum>;
+    auto const& values = sorted_values_v<Enum>.values;
+    value_run_layout layout;
+    for_each_value_run<Enum>([&](size_t first, size_t last) {
+        if (last - first + 1 >= min_run_size) {
+            layout.num_runs++;
+            layout.num_slots += info::distance(values[first], values[last]) + 1;
+        } else {
+            layout.num_outliers += last - first + 1;
+        }
+    });
+    return layout;
+}
+
+// Reaching this function during constant evaluation is a compile error, since
+// it isn't constexpr. It's called when multiply_shift_hash can't find a
+// multiplier.
+inline void multiply_shift_hash_could_not_find_a_multiplier() {}
+
+/**
+ * @brief A perfect hash of N distinct integers, which maps each of them to a
+ * different slot of a table with table_size slots.
+ *
+ * Keys are multiplied by an odd multiplier. The top bits of the product pick a
+ * bucket, and the bits below them pick a slot, which is XORed with the
+ * displacement of the bucket. On construction, we search for a multiplier,
+ * together with a displacement for each bucket, such that every key gets a
+ * slot of its own. Finding a slot costs one multiply, two shifts, and one load.
+ */
+template <size_t N>
+struct multiply_shift_hash {
+    // The table has at least one empty slot, and there is one bucket per slot
+    constexpr static int get_table_bits() noexcept {
+        int bits = 1;
+        while ((size_t(1) << bits) <= N) {
+            bits++;
+        }
+        return bits;
+    }
+    constexpr static int table_bits = get_table_bits();
+    constexpr static size_t table_size = size_t(1) << table_bits;
+    constexpr static uint64_t max_multipliers = 64;
+    // Multipliers that put more keys than this in one bucket are rejected
+    constexpr static size_t max_bucket_size = 16;
+    // Displacements tried for each bucket with more than one key
+    constexpr static size_t max_displacement_tries =
+        table_size < 1024 ? table_size : 1024;
+    using displacement_type = uint_fit_t<table_size - 1>;
+
+    uint64_t multiplier = 0;
+    std::array<displacement_type, table_size> displacements {};
+
+    // Gets the ith multiplier to try, by scrambling i with the finalizer of
+    // splitmix64. Multiples of the golden ratio would be simpler, but keys
+    // drawn from the Fibonacci sequence all collide under them
+    constexpr static uint64_t get_multiplier(uint64_t i) noexcept {
+        uint64_t x = i * 0x9e3779b97f4a7c15;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+        return (x ^ (x >> 31)) | 1;
+    }
+    // Computes the bucket, and the slot before it's displaced
+    constexpr static size_t bucket_of(uint64_t h) noexcept {
+        return size_t(h >> (64 - table_bits));
+    }
+    constexpr static size_t base_slot_of(uint64_t h) noexcept {
+        return size_t(h >> (64 - 2 * table_bits)) & (table_size - 1);
+    }
+    constexpr size_t slot_of(uint64_t key) const noexcept {
+        uint64_t h = key * multiplier;
+        return base_slot_of(h) ^ displacements[bucket_of(h)];
+    }
+
+    // This runs during constant evaluation, once per multiplier tried, so it's
+    // written to be cheap to evaluate: every pass is linear in the size of the
+    // table, and arrays are indexed through pointers, since each call to
+    // std::array::operator[] is costly to evaluate
+    constexpr bool try_multiplier(std::array<uint64_t, N> const& keys) {
+        std::array<size_t, table_size + 1> bucket_start_array {};
+        size_t* bucket_start = bucket_start_array.data();
+        for (uint64_t key : keys) {
+            bucket_start[bucket_of(key * multiplier) + 1]++;
+        }
+        for (size_t b = 0; b < table_size; b++) {
+            if (bucket_start[b + 1] > max_bucket_size) {
+                return false;
+            }
+            bucket_start[b + 1] += bucket_start[b];
+        }
+        // The base slot of each key, grouped by bucket
+        std::array<size_t, N> members_array {};
+        size_t* members = members_array.data();
+        {
+            std::array<size_t, table_size> filled_array {};
+            size_t* filled = filled_array.data();
+            for (uint64_t key : keys) {
+                uint64_t h = key * multiplier;
+                size_t b = bucket_of(h);
+                members[bucket_start[b] + filled[b]++] = base_slot_of(h);
+            }
+        }
+        // Larger buckets are harder to place, so we place them first. Buckets
+        // hold only a few keys, so they're ordered with a counting sort, which
+        // skips empty buckets
+        std::array<size_t, max_bucket_size + 1> size_start_array {};
+        size_t* size_start = size_start_array.data();
+        for (size_t b = 0; b < table_size; b++) {
+            size_t size = bucket_start[b + 1] - bucket_start[b];
+            if (size > 0) {
+                size_start[max_bucket_size + 1 - size]++;
+            }
+        }
+        for (size_t i = 0; i < max_bucket_size; i++) {
+            size_start[i + 1] += size_start[i];
+        }
+        size_t num_buckets = size_start[max_bucket_size];
+        std::array<size_t, table_size> order_array {};
+        size_t* order = order_array.data();
+        for (size_t b = 0; b < table_size; b++) {
+            size_t size = bucket_start[b + 1] - bucket_start[b];
+            if (size > 0) {
+                order[size_start[max_bucket_size - size]++] = b;
+            }
+        }
+
+        std::array<bool, table_size> occupied_array {};
+        bool* occupied = occupied_array.data();
+        // Every slot before this one is occupied
+        size_t free_slot = 0;
+        for (size_t i = 0; i < num_buckets; i++) {
+            size_t b = order[i];
+            size_t const* first = members + bucket_start[b];
+            size_t const* last = members + bucket_start[b + 1];
+            if (last - first == 1) {
+                // A bucket with one key can take any free slot
+                while (occupied[free_slot]) {
+                    free_slot++;
+                }
+                occupied[free_slot] = true;
+                displacements[b] = displacement_type(*first ^ free_slot);
+                continue;
+            }
+            bool placed = false;
+            for (size_t d = 0; d < max_displacement_tries && !placed; d++) {
+                size_t const* it = first;
+                for (; it != last; ++it) {
+                    if (occupied[*it ^ d]) {
+                        break;
+                    }
+                    occupied[*it ^ d] = true;
+                }
+                placed = it == last;
+                // Release any slots we claimed if the bucket didn't fit
+                if (!placed) {
+                    while (it != first) {
+                        occupied[*--it ^ d] = false;
+                    }
+                } else {
+                    displacements[b] = displacement_type(d);
+                }
+            }
+            // If a bucket doesn't fit after this many tries, it's cheaper to
+            // try another multiplier than to keep searching
+            if (!placed) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    constexpr multiply_shift_hash() = default;
+    constexpr multiply_shift_hash(std::array<uint64_t, N> const& keys) {
+        if constexpr (N > 0) {
+            for (uint64_t i = 1; i <= max_multipliers; i++) {
+                multiplier = get_multiplier(i);
+                displacements = {};
+                if (try_multiplier(keys)) {
+                    return;
+                }
+            }
+            multiply_shift_hash_could_not_find_a_multiplier();
+        }
+    }
+};
+
+// Maps values to ordinals for enums whose values are spread out. Values which
+// are close together are grouped into runs, each with its own table indexed by
+// value, so enums made of a few dense clusters (like status codes) only pay
+// for a search over the runs. Outliers are found with a perfect hash.
+template <class Enum>
+struct value_index<Enum, false> : value_index_info<Enum> {
+    using info = value_index_info<Enum>;
+    using typename info::base_type;
+    using typename info::ordinal_type;
+    using typename info::unsigned_type;
+    constexpr static value_run_layout layout = get_value_run_layout<Enum>();
+    using slot_type = uint_fit_t<layout.num_slots>;
+    // The first value in each run, in ascending order, the distance from the
+    // first value to the last, and the position of the run's table in slots
+    std::array<base_type, layout.num_runs> run_firsts {};
+    std::array<unsigned_type, layout.num_runs> run_lengths {};
+    std::array<slot_type, layout.num_runs> run_starts {};
+    // Ordinals of the values in each run. The value `size` marks a gap
+    std::array<ordinal_type, layout.num_slots> slots {};
+    // Outliers, and their ordinals, are placed in the slot given by a perfect
+    // hash of the value. Empty slots hold the first outlier, which has a slot
+    // of its own, so it can never be matched against an empty slot
+    using outlier_hash = multiply_shift_hash<layout.num_outliers>;
+    constexpr static size_t outlier_table_size =
+        layout.num_outliers > 0 ? outlier_hash::table_size : 0;
+    outlier_hash hash;
+    std::array<base_type, outlier_table_size> outliers {};
+    std::array<ordinal_type, outlier_table_size> outlier_ordinals {};
+
+    constexpr value_index() {
+        auto const& sorted = sorted_values_v<Enum>;
+        for (auto& ordinal : slots) {
+            ordinal = ordinal_type(info::size);
+        }
+        // Positions in sorted of the values which aren't in a run
+        std::array<size_t, layout.num_outliers> outlier_positions {};
+        size_t run = 0;
+        size_t slot = 0;
+        size_t outlier = 0;
+        for_each_value_run<Enum>([&](size_t first, size_t last) {
+            if (last - first + 1 >= min_run_size) {
+                base_type start = sorted.values[first];
+                run_firsts[run] = start;
+                run_lengths[run] = info::distance(start, sorted.values[last]);
+                run_starts[run] = slot_type(slot);
+                for (size_t i = first; i <= last; i++) {
+                    slots[slot + info::distance(start, sorted.values[i])] =
+                        sorted.ordinals[i];
+                }
+                slot += run_lengths[run] + size_t(1);
+                run++;
+            } else {
+                for (size_t i = first; i <= last; i++) {
+                    outlier_positions[outlier++] = i;
+                }
+            }
+        });
+        if constexpr (layout.num_outliers > 0) {
+            // These loops cover the whole table, so arrays are indexed through
+            // pointers, which are cheaper to evaluate than std::array
+            auto const* values = sorted.values.data();
+            auto const* ordinals = sorted.ordinals.data();
+            size_t const* positions = outlier_positions.data();
+            std::array<uint64_t, layout.num_outliers> keys {};
+            for (size_t i = 0; i < layout.num_outliers; i++) {
+                keys[i] = hash_key(values[positions[i]]);
+            }
+            hash = outlier_hash(keys);
+            base_type* table = outliers.data();
+            ordinal_type* table_ordinals = outlier_ordinals.data();
+            for (size_t i = 0; i < outlier_table_size; i++) {
+                table[i] = values[positions[0]];
+                table_ordinals[i] = ordinals[positions[0]];
+            }
+            for (size_t i = 0; i < layout.num_outliers; i++) {
+                size_t slot = hash.slot_of(keys[i]);
+                table[slot] = values[positions[i]];
+                table_ordinals[slot] = ordinals[positions[i]];
+            }
+        }
+    }
+    // Values are hashed as unsigned integers, so distinct values give distinct
+    // keys
+    constexpr static uint64_t hash_key(base_type value) noexcept {
+        return uint64_t(unsigned_type(value));
+    }
+    // The search over the runs is written so that the compiler can use a
+    // conditional move rather than a branch, since the branch would be
+    // mispredicted about half the time
+    constexpr size_t find(Enum value) const noexcept {
+        base_type key = base_type(value);
+        if constexpr (layout.num_runs > 0) {
+            // Find the last run which starts at or before key. If key is less
+            // than the first value in the run, the distance wraps around, and
+            // is larger than the length of the run
+            size_t run = 0;
+            size_t length = layout.num_runs;
+            while (length > 1) {
+                size_t half = length / 2;
+                run = run_firsts[run + half] <= key ? run + half : run;
+                length -= half;
+            }
+            unsigned_type offset = info::distance(run_firsts[run], key);
+            if (offset <= run_lengths[run]) {
+                return slots[run_starts[run] + offset];
+            }
+        }
+        if constexpr (layout.num_outliers > 0) {
+            size_t slot = hash.slot_of(hash_key(key));
+            if (outliers[slot] == key) {
+                return outlier_ordinals[slot];
+            }
+        }
+        return info::size;
+    }
+};
+
+template <class Enum>
+constexpr value_index<Enum> value_index_v {};
+
+// Maps names to ordinals by binary search over ordinals sorted by name. Names
+// are read from the enum's name block, rather than being copied.
+template <class Enum, bool IgnoreCase>
+struct name_index {
+    using ordinal_type = typename value_index_info<Enum>::ordinal_type;
+    constexpr static size_t size = num_states<Enum>;
+    std::array<ordinal_type, size> ordinals {};
+
+    constexpr name_index() {
+        for (size_t i = 0; i < size; i++) {
+            ordinals[i] = ordinal_type(i);
+        }
+        stable_sort(ordinals, [](ordinal_type a, ordinal_type b) {
+            return compare_names<IgnoreCase>(
+                       enum_names<Enum>[a],
+                       enum_names<Enum>[b])
+                 < 0;
+        });
+    }
+    // Finds the first declared name matching the given name. Returns size if
+    // there's no match
+    constexpr size_t find(std::string_view name) const noexcept {
+        size_t lower = 0;
+        size_t upper = size;
+        while (lower < upper) {
+            size_t mid = (lower + upper) / 2;
+            if (compare_names<IgnoreCase>(enum_names<Enum>[ordinals[mid]], name)
+                < 0) {
+                lower = mid + 1;
+            } else {
+                upper = mid;
+            }
+        }
+        if (lower < size
+            && compare_names<IgnoreCase>(enum_names<Enum>[ordinals[lower]], name)
+                   == 0) {
+            return ordinals[lower];
+        } else {
+            return size;
+        }
+    }
+};
+
+template <class Enum, bool IgnoreCase>
+constexpr name_index<Enum, IgnoreCase> name_index_v {};
+
+// Maps each bit position to the first name declared for the value with just
+// that bit set, so that a flag value can be named one set bit at a time
+template <class Enum>
+struct flag_index {
+    using ordinal_type = typename value_index_info<Enum>::ordinal_type;
+    using unsigned_type = typename value_index_info<Enum>::unsigned_type;
+    constexpr static size_t size = num_states<Enum>;
+    constexpr static size_t num_bits = sizeof(unsigned_type) * 8;
+    // Ordinals of single-bit values, ordered by bit position. The value `size`
+    // marks a bit with no name
+    std::array<ordinal_type, num_bits> ordinals {};
+    // The bits which have a name
+    unsigned_type named_bits = 0;
+
+    constexpr flag_index() {
+        for (auto& ordinal : ordinals) {
+            ordinal = ordinal_type(size);
+        }
+        // Iterate in reverse, so that aliased values get the ordinal of the
+        // first name declared for that value
+        for (size_t i = size; i-- > 0;) {
+            auto bits = unsigned_type(enum_values<Enum>[i]);
+            if (bits != 0 && (bits & (bits - 1)) == 0) {
+                ordinals[countr_zero(bits)] = ordinal_type(i);
+                named_bits |= bits;
+            }
+        }
+    }
+};
+
+template <class Enum>
+constexpr flag_index<Enum> flag_index_v {};
+
+// Calls fn with the name of each set bit, in order of bit position. Returns
+// false without calling fn if any set bit has no name, or if no bits are set
+template <class Enum, class Fn>
+constexpr bool for_each_flag_bit_name(Enum value, Fn&& fn) {
+    auto const& index = flag_index_v<Enum>;
+    uint64_t bits = typename flag_index<Enum>::unsigned_type(value);
+    if (bits == 0 || (bits & ~uint64_t(index.named_bits)) != 0) {
+        return false;
+    }
+    for (; bits != 0; bits &= bits - 1) {
+        fn(enum_names<Enum>[index.ordinals[countr_zero(bits)]]);
+    }
+    return true;
+}
+} // namespace nav::detail
+
+namespace nav {
+template <class Enum>
+constexpr size_t ordinal_of(Enum value) noexcept {
+    return detail::value_index_v<Enum>.find(value);
+}
+template <class Enum>
+constexpr bool name_of(
+    Enum value,
+    std::string_view& dest,
+    bool use_lowercase) noexcept {
+    size_t i = ordinal_of(value);
+    if (i < num_states<Enum>) {
+        dest = use_lowercase ? detail::lowercase_name_block<Enum>[i]
+                             : enum_names<Enum>[i];
+        return true;
+    } else {
+        return false;
+    }
+}
+template <class Enum>
+constexpr auto name_of(Enum value, bool use_lowercase) noexcept
+    -> std::optional<std::string_view> {
+    std::string_view name;
+    if (name_of(value, name, use_lowercase)) {
+        return name;
+    } else {
+        return std::nullopt;
+    }
+}
+template <class Enum>
+constexpr bool value_of(
+    std::string_view name,
+    Enum& dest,
+    bool ignore_case) noexcept {
+    auto find = [ignore_case](std::string_view name) {
+        return ignore_case ? detail::name_index_v<Enum, true>.find(name)
+                           : detail::name_index_v<Enum, false>.find(name);
+    };
+    if constexpr (is_flag_enum<Enum>) {
+        // Flag enums also accept a list of names, such as "A|B|C"
+        using unsigned_type = typename detail::flag_index<Enum>::unsigned_type;
+        unsigned_type bits = 0;
+        for (;;) {
+            size_t separator = name.find('|');
+            size_t i = find(name.substr(0, separator));
+            if (i >= num_states<Enum>) {
+                return false;
+            }
+            bits |= unsigned_type(enum_values<Enum>[i]);
+            if (separator == name.npos) {
+                break;
+            }
+            name.remove_prefix(separator + 1);
+        }
+        dest = Enum(bits);
+        return true;
+    } else {
+        size_t i = find(name);
+        if (i < num_states<Enum>) {
+            dest = enum_values<Enum>[i];
+            return true;
+        } else {
+            return false;
+        }
+    }
+}
+template <class Enum>
+constexpr auto value_of(std::string_view name, bool ignore_case) noexcept
+    -> std::optional<Enum> {
+    Enum value {};
+    if (value_of(name, value, ignore_case)) {
+        return value;
+    } else {
+        return std::nullopt;
+    }
+}
+template <class Enum, class Fn>
+constexpr bool for_each_flag_name(Enum value, Fn&& fn) {
+    std::string_view name;
+    if (name_of(value, name)) {
+        fn(name);
+        return true;
+    }
+    return detail::for_each_flag_bit_name(value, fn);
+}
+} // namespace nav
+
+#define NAV_DECLARE_ENUM_IMPL(EnumType, BaseType, IsFlagEnum, ...)             \
     enum class EnumType : BaseType { __VA_ARGS__ };                            \
     namespace nav::detail {                                                    \
     template <>                                                                \
@@ -507,12 +1522,9 @@ constexpr enum_name_list<Enum> enum_names {};
         constexpr static std::string_view qualified_type_name = #EnumType;     \
         constexpr static std::string_view type_name = get_top_name(#EnumType); \
         constexpr static bool is_nav_enum = true;                              \
-        constexpr static size_t num_states = []() -> size_t {                  \
-            enum_maker<BaseType> __VA_ARGS__;                                  \
-            enum_maker<BaseType> NAV_DECLARE_ENUM_vals[] {__VA_ARGS__};        \
-            return sizeof(NAV_DECLARE_ENUM_vals)                               \
-                 / sizeof(enum_maker<BaseType>);                               \
-        }();                                                                   \
+        constexpr static bool is_flag_enum = IsFlagEnum;                       \
+        constexpr static name_layout layout = get_name_layout(#__VA_ARGS__);   \
+        constexpr static size_t num_states = layout.num_names;                 \
         constexpr static size_t size() noexcept {                              \
             return num_states;                                                 \
         }                                                                      \
@@ -523,33 +1535,64 @@ constexpr enum_name_list<Enum> enum_names {};
         constexpr enum_value_list_base()                                       \
           : values() {                                                         \
             enum_maker<BaseType> __VA_ARGS__;                                  \
-            value_assigner<BaseType> {}, __VA_ARGS__;                          \
-            enum_maker<BaseType> NAV_DECLARE_ENUM_vals[] {__VA_ARGS__};        \
+            enum_value_slot<BaseType> NAV_DECLARE_ENUM_slots[] {               \
+                enum_value_slot<BaseType>(),                                   \
+                __VA_ARGS__};                                                  \
+            static_assert(                                                     \
+                sizeof(NAV_DECLARE_ENUM_slots)                                 \
+                    == sizeof(enum_value_slot<BaseType>)                       \
+                           * (enum_type_info_base<EnumType>::num_states + 1),  \
+                "Expected one name for each enumerator");                      \
             for (size_t i = 0; i < enum_type_info_base<EnumType>::num_states;  \
-                 i++)                                                          \
-                this->values[i] = EnumType(NAV_DECLARE_ENUM_vals[i]);          \
+                 i++) {                                                        \
+                this->values[i] = EnumType(                                    \
+                    NAV_DECLARE_ENUM_slots[i + 1].value);                      \
+            }                                                                  \
         }                                                                      \
     };                                                                         \
     template <>                                                                \
     struct enum_name_list_base<EnumType> : enum_type_info_base<EnumType> {     \
         using enum_type_info_base<EnumType>::num_states;                       \
-        constexpr static size_t                                                \
-            name_block_size = compute_name_block_size<num_states>(             \
-                #__VA_ARGS__);                                                 \
+        constexpr static size_t name_block_size = layout.block_size;           \
         using block_type = string_block<num_states, name_block_size>;          \
         block_type name_block;                                                 \
         constexpr enum_name_list_base()                                        \
           : name_block([](auto& block) {                                       \
-              write_names_and_sizes<num_states>(                               \
-                  #__VA_ARGS__,                                                \
-                  block.data,                                                  \
-                  block.offsets);                                              \
+              write_names_and_sizes(#__VA_ARGS__, block.data, block.offsets);  \
           }) {}                                                                \
     };                                                                         \
     } // namespace nav::detail
 
+#define NAV_DECLARE_ENUM(EnumType, BaseType, ...)                              \
+    NAV_DECLARE_ENUM_IMPL(EnumType, BaseType, false, __VA_ARGS__)
+
+// Brings the bitwise operators for flag enums into the current namespace.
+// Place this in the namespace a flag enum is declared in, so that
+// argument-dependent lookup finds the operators even where that namespace
+// declares operators of its own
+#define NAV_DECLARE_FLAG_OPERATORS()                                           \
+    using ::nav::flag_operators::operator~;                                    \
+    using ::nav::flag_operators::operator|;                                    \
+    using ::nav::flag_operators::operator&;                                    \
+    using ::nav::flag_operators::operator^;                                    \
+    using ::nav::flag_operators::operator|=;                                   \
+    using ::nav::flag_operators::operator&=;                                   \
+    using ::nav::flag_operators::operator^=
+
+// Declares an enum whose values are bit flags. Values made up of several
+// flags are named one flag at a time (eg, "Read|Write"), and parsed the same
+// way. The enum also gets the bitwise operators ~, |, &, and ^. These are
+// brought into the global namespace here; enums declared in another namespace
+// should use NAV_DECLARE_FLAG_OPERATORS there as well
+#define NAV_DECLARE_FLAG_ENUM(EnumType, BaseType, ...)                         \
+    NAV_DECLARE_ENUM_IMPL(EnumType, BaseType, true, __VA_ARGS__)               \
+    NAV_DECLARE_FLAG_OPERATORS()
+
 #ifndef NAV_NO_PRETTY_MACROS
 #define nav_declare_enum(EnumType, BaseType, ...)                              \
     NAV_DECLARE_ENUM(EnumType, BaseType, __VA_ARGS__)
+#define nav_declare_flag_enum(EnumType, BaseType, ...)                         \
+    NAV_DECLARE_FLAG_ENUM(EnumType, BaseType, __VA_ARGS__)
+#define nav_declare_flag_operators() NAV_DECLARE_FLAG_OPERATORS()
 #endif
 #endif
@@ -0,0 +1,208 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <memory>
+#include <nav/nav_atomic.hpp>
+#include <nav/nav_charconv.hpp>
+#include <nav/nav_containers.hpp>
+#include <thread>
+
+namespace nav::detail {
+// Thread indices are handed out from this bitmap, one bit per index. It's
+// trivially destructible, so threads which exit after main returns can still
+// give back their index
+constexpr size_t max_thread_indices = 4096;
+inline std::atomic<uint64_t> thread_index_bits[max_thread_indices / 64] {};
+inline std::atomic<size_t> next_overflow_thread_index {max_thread_indices};
+
+// Claims the lowest free index. Past max_thread_indices live threads, indices
+// are handed out from a counter instead, and never given back
+inline size_t acquire_thread_index() noexcept {
+    for (size_t w = 0; w < max_thread_indices / 64; w++) {
+        uint64_t bits = thread_index_bits[w].load(std::memory_order_relaxed);
+        while (bits != ~uint64_t(0)) {
+            size_t i = size_t(countr_zero(~bits));
+            if (thread_index_bits[w].compare_exchange_weak(
+                    bits,
+                    bits | uint64_t(1) << i,
+                    std::memory_order_relaxed)) {
+                return w * 64 + i;
+            }
+        }
+    }
+    return next_overflow_thread_index.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Holds the index of a thread, and gives it back when the thread exits
+struct thread_index_slot {
+    size_t index = acquire_thread_index();
+    ~thread_index_slot() {
+        if (index < max_thread_indices) {
+            thread_index_bits[index / 64].fetch_and(
+                ~(uint64_t(1) << (index % 64)),
+                std::memory_order_relaxed);
+        }
+    }
+};
+
+// A number for the calling thread. Each thread takes the lowest number not
+// held by a running thread, so running threads have different numbers, all
+// less than the largest number of threads that have run at once
+inline size_t this_thread_index() noexcept {
+    thread_local thread_index_slot slot;
+    return slot.index;
+}
+} // namespace nav::detail
+
+namespace nav {
+/**
+ * @brief Write a line with the name and count of each value, as in
+ * "Timeout 12\n", in declaration order. Each value is written once, with the
+ * first name declared for it.
+ *
+ * @param first the start of the output
+ * @param last the end of the output
+ * @param counts the count of each value
+ * @return std::to_chars_result {end of output, std::errc {}} on success, and
+ * {last, std::errc::value_too_large} if the output doesn't fit
+ */
+template <class Enum>
+constexpr std::to_chars_result write_counts(
+    char* first,
+    char* last,
+    enum_map<Enum, int64_t> const& counts) noexcept {
+    for (auto [value, name, count] : counts) {
+        (void)value;
+        first = detail::copy_chars(first, last, name);
+        first = detail::copy_chars(first, last, " ");
+        if (first == nullptr) {
+            return {last, std::errc::value_too_large};
+        }
+        auto result = detail::integer_to_chars(first, last, count);
+        if (result.ec != std::errc {}) {
+            return result;
+        }
+        first = detail::copy_chars(result.ptr, last, "\n");
+        if (first == nullptr) {
+            return {last, std::errc::value_too_large};
+        }
+    }
+    return {first, std::errc {}};
+}
+
+/**
+ * @brief Counts events by enum value, from many threads at once.
+ *
+ * The counters are split into shards, each holding one std::atomic<int64_t>
+ * per ordinal, padded and aligned to whole cache lines. Each thread adds to
+ * the shard given by its thread number. Running threads have different
+ * numbers, and a thread's number is given to a new thread once it exits, so
+ * as long as no more threads run at once than there are shards, no two
+ * threads write to the same cache line, and an increment never has to wait
+ * for another core. With more threads than shards, threads share shards, and
+ * increments are still exact.
+ *
+ * snapshot() sums the shards. It doesn't stop other threads, so increments
+ * made while it runs may or may not be included.
+ *
+ * @tparam Enum the enumeration type
+ */
+template <class Enum>
+class enum_counters {
+    constexpr static size_t counters_per_line = detail::cache_line_size
+                                              / sizeof(std::atomic<int64_t>);
+    // The number of counters in a shard, rounded up to whole cache lines
+    constexpr static size_t shard_size =
+        (num_states<Enum> + counters_per_line - 1) / counters_per_line
+        * counters_per_line;
+
+    struct alignas(detail::cache_line_size) shard {
+        std::array<std::atomic<int64_t>, shard_size> counts {};
+    };
+
+    // The number of shards is a power of 2, so a thread's shard is found
+    // with a mask rather than a division
+    size_t shard_mask = 0;
+    std::unique_ptr<shard[]> shards;
+
+    constexpr static size_t round_up_to_power_of_2(size_t count) noexcept {
+        size_t result = 1;
+        while (result < count) {
+            result *= 2;
+        }
+        return result;
+    }
+
+   public:
+    // At least one shard per hardware thread
+    static size_t default_num_shards() noexcept {
+        size_t count = std::thread::hardware_concurrency();
+        return count > 0 ? count : 1;
+    }
+    // The size of the longest output write_to could produce: every name,
+    // followed by a space, the longest int64_t, and a newline
+    constexpr static size_t max_output_size = [] {
+        auto const& unique = detail::unique_ordinals_v<Enum>;
+        size_t size = 0;
+        for (size_t i = 0; i < unique.size; i++) {
+            size += enum_names<Enum>[unique.ordinals[i]].size() + 22;
+        }
+        return size;
+    }();
+
+    // num_shards is rounded up to a power of 2
+    explicit enum_counters(size_t num_shards = default_num_shards())
+      : shard_mask(round_up_to_power_of_2(num_shards) - 1)
+      , shards(new shard[shard_mask + 1]()) {}
+
+    size_t num_shards() const noexcept {
+        return shard_mask + 1;
+    }
+
+    // Adds n to the count of value. Returns false, and does nothing, if the
+    // value has no name
+    bool add(Enum value, int64_t n = 1) noexcept {
+        size_t i = ordinal_of(value);
+        if (i >= num_states<Enum>) {
+            return false;
+        }
+        shard& local = shards[detail::this_thread_index() & shard_mask];
+        local.counts[i].fetch_add(n, std::memory_order_relaxed);
+        return true;
+    }
+
+    // The sum of the counts of each value over every shard
+    enum_map<Enum, int64_t> snapshot() const noexcept {
+        std::array<int64_t, num_states<Enum>> totals {};
+        for (size_t s = 0; s < num_shards(); s++) {
+            for (size_t i = 0; i < num_states<Enum>; i++) {
+                totals[i] += shards[s].counts[i].load(
+                    std::memory_order_relaxed);
+            }
+        }
+        enum_map<Enum, int64_t> result;
+        for (auto [value, name, count] : result) {
+            (void)name;
+            count = totals[ordinal_of(value)];
+        }
+        return result;
+    }
+
+    // Sets every count to 0. Increments made at the same time may be lost
+    void reset() noexcept {
+        for (size_t s = 0; s < num_shards(); s++) {
+            for (auto& count : shards[s].counts) {
+                count.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Writes snapshot() with write_counts. The output fits if there are at
+    // least max_output_size bytes
+    std::to_chars_result write_to(char* first, char* last) const noexcept {
+        return write_counts<Enum>(first, last, snapshot());
+    }
+};
+} // namespace nav
@@ -1,9 +1,209 @@
 #pragma once
-#include <nav/nav_core.hpp>
+#include <nav/core.hpp>
+#include <limits>
 #include <string_view>
 
 namespace nav {
 using size_t = decltype(sizeof(0));
+namespace detail {
+// The state of one 64-row block of the edit distance matrix, stored as the
+// vertical differences between adjacent rows of the current column. A set bit
+// in pv means the row is one more than the row above it, and a set bit in mv
+// means it's one less
+struct myers_block {
+    uint64_t pv = ~uint64_t(0);
+    uint64_t mv = 0;
+};
+
+/**
+ * @brief Advance a block to the next column of the matrix (Myers' algorithm,
+ * in the form given by Hyyrö). Returns the horizontal difference at out_bit,
+ * which is the carry into the next block.
+ *
+ * @param block the block to advance
+ * @param eq bitmask of the pattern rows equal to the next character
+ * @param carry_in horizontal difference on the row above the block (-1, 0, or
+ * 1)
+ * @param out_bit bitmask selecting the last row of the block
+ * @return int the horizontal difference on the last row of the block
+ */
+constexpr int advance_block(
+    myers_block& block,
+    uint64_t eq,
+    int carry_in,
+    uint64_t out_bit) {
+    uint64_t pv = block.pv;
+    uint64_t mv = block.mv;
+    uint64_t xv = eq | mv;
+    eq |= uint64_t(carry_in < 0);
+    uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+    uint64_t ph = mv | ~(xh | pv);
+    uint64_t mh = pv & xh;
+    int carry_out = int((ph & out_bit) != 0) - int((mh & out_bit) != 0);
+    ph = (ph << 1) | uint64_t(carry_in > 0);
+    mh = (mh << 1) | uint64_t(carry_in < 0);
+    block.pv = mh | ~(xv | ph);
+    block.mv = ph & xv;
+    return carry_out;
+}
+
+/**
+ * @brief Check whether every cell of a column of the distance matrix is greater
+ * than max_distance (Ukkonen's cut-off). A cell is at least as large as its
+ * distance from the diagonal, so only the cells within max_distance rows of the
+ * diagonal are checked. Their values are recovered from the vertical
+ * differences stored in the blocks, starting from the first row of the column.
+ * This takes O(max_distance) steps, plus one popcount per block above the band.
+ *
+ * @param blocks the blocks holding the column
+ * @param length the number of rows below the first row (the pattern length)
+ * @param column the index of the column, which is the value of its first row
+ * @param max_distance the threshold
+ */
+constexpr bool column_exceeds(
+    myers_block const* blocks,
+    size_t length,
+    size_t column,
+    size_t max_distance) noexcept {
+    size_t first = column > max_distance ? column - max_distance : 0;
+    size_t last = std::min(length, column + max_distance);
+    if (first > last) {
+        return true;
+    }
+    // Row r of the matrix is one more or one less than row r - 1 when bit
+    // r - 1 of pv or mv is set, so the value of the first row of the band is
+    // the value of row 0 plus the number of pv bits above it, minus the number
+    // of mv bits
+    int value = int(column);
+    for (size_t b = 0; b < first / 64; b++) {
+        value += popcount(blocks[b].pv) - popcount(blocks[b].mv);
+    }
+    if (first % 64 != 0) {
+        uint64_t mask = ~uint64_t(0) >> (64 - first % 64);
+        myers_block const& block = blocks[first / 64];
+        value += popcount(block.pv & mask) - popcount(block.mv & mask);
+    }
+    for (size_t r = first;; r++) {
+        if (value <= int(max_distance)) {
+            return false;
+        }
+        if (r == last) {
+            return true;
+        }
+        uint64_t bit = uint64_t(1) << (r % 64);
+        value += int((blocks[r / 64].pv & bit) != 0)
+               - int((blocks[r / 64].mv & bit) != 0);
+    }
+}
+
+/**
+ * @brief A pattern prepared for computing the Levenshtein distance to many
+ * strings, using the bit-parallel algorithm of Myers. Each column of the
+ * distance matrix takes one step per 64 characters of the pattern, instead of
+ * one step per character.
+ *
+ * The pattern is truncated to MaxLength characters, and so are the strings
+ * it's compared against.
+ *
+ * @tparam MaxLength the maximum length to measure the distance out to.
+ */
+template <size_t MaxLength>
+class levenshtein_pattern {
+    constexpr static size_t max_blocks = MaxLength / 64 + 1;
+
+    // masks[ch][i] has bit j set if character 64 * i + j of the pattern
+    // matches ch
+    uint64_t masks[256][max_blocks] {};
+    size_t length = 0;
+
+   public:
+    /**
+     * @brief Prepare a pattern. If ignore_case is true, both cases of each
+     * letter in the pattern are added to the masks, so that strings are
+     * compared ignoring ASCII case without having to convert them.
+     */
+    constexpr levenshtein_pattern(std::string_view pattern, bool ignore_case)
+      : length(std::min(MaxLength, pattern.size())) {
+        for (size_t i = 0; i < length; i++) {
+            uint64_t bit = uint64_t(1) << (i % 64);
+            char ch = pattern[i];
+            masks[(unsigned char)ch][i / 64] |= bit;
+            if (ignore_case) {
+                char lower = to_lower(ch);
+                char upper = 'a' <= ch && ch <= 'z' ? ch - 'a' + 'A' : ch;
+                masks[(unsigned char)lower][i / 64] |= bit;
+                masks[(unsigned char)upper][i / 64] |= bit;
+            }
+        }
+    }
+
+    /**
+     * @brief Compute the Levenshtein distance between the pattern and the
+     * given string. If the distance is greater than max_distance, gives up
+     * early and returns max_distance + 1.
+     *
+     * The smallest value in a column of the matrix never decreases from one
+     * column to the next, so the string is abandoned as soon as every cell of
+     * a column exceeds max_distance (Ukkonen's cut-off). When max_distance is
+     * at least the length of the pattern, this check is skipped, since it would
+     * cost a step per row. The distance so far can also only go down by one
+     * for each character left in the string, so the string is abandoned once
+     * the distance minus the remaining characters exceeds max_distance.
+     */
+    constexpr int distance(
+        std::string_view str,
+        int max_distance = std::numeric_limits<int>::max()) const {
+        size_t str_length = std::min(MaxLength, str.size());
+        size_t length_difference = length > str_length
+                                     ? length - str_length
+                                     : str_length - length;
+        if (length_difference > size_t(max_distance)) {
+            return max_distance + 1;
+        }
+        if (length == 0) {
+            return int(str_length);
+        }
+        size_t num_blocks = (length + 63) / 64;
+        uint64_t last_bit = uint64_t(1) << ((length - 1) % 64);
+        myers_block blocks[max_blocks] {};
+        int dist = int(length);
+        int remaining = int(str_length);
+        bool check_columns = size_t(max_distance) < length;
+        for (size_t i = 0; i < str_length; i++) {
+            uint64_t const* eq = masks[(unsigned char)str[i]];
+            // Going across a column of the matrix, the first row increases by
+            // one each time
+            int carry = 1;
+            for (size_t b = 0; b + 1 < num_blocks; b++) {
+                carry = advance_block(
+                    blocks[b],
+                    eq[b],
+                    carry,
+                    uint64_t(1) << 63);
+            }
+            dist += advance_block(
+                blocks[num_blocks - 1],
+                eq[num_blocks - 1],
+                carry,
+                last_bit);
+            remaining--;
+            if (dist - remaining > max_distance) {
+                return max_distance + 1;
+            }
+            if (check_columns
+                && column_exceeds(
+                    blocks,
+                    length,
+                    i + 1,
+                    size_t(max_distance))) {
+                return max_distance + 1;
+            }
+        }
+        return dist;
+    }
+};
+} // namespace detail
+
 /**
  * @brief Compute the Levenshtein distance through MaxLength (this should be
  * used when one of the strings has a known max length, and so there's no need
@@ -19,56 +219,300 @@ using size_t = decltype(sizeof(0));
 template <size_t MaxLength>
 constexpr auto levenshtein_distance =
     [](std::string_view strA, std::string_view strB) -> int {
-    // for all i and j, dist[i,j] will hold the Levenshtein distance between
-    // the first i characters of s and the first j characters of t
-    int dist[MaxLength + 1][MaxLength + 1];
-    size_t lenA = std::min(MaxLength, strA.size());
-    size_t lenB = std::min(MaxLength, strB.size());
-
-    // source prefixes can be transformed into empty string by
-    // dropping all characters
-    for (size_t ai = 0; ai <= lenA; ai++)
-        dist[ai][0] = ai;
-
-    // target prefixes can be reached from empty source prefix
-    // by inserting every character
-    for (size_t bi = 0; bi <= lenB; bi++)
-        dist[0][bi] = bi;
-
-    for (size_t bi = 0; bi < lenB; bi++) {
-        for (size_t ai = 0; ai < lenA; ai++) {
-            int substitutionCost = !(strA[ai] == strB[bi]);
-
-            dist[ai + 1][bi + 1] = std::min(
-                std::min(
-                    dist[ai][bi + 1] + 1,         // deletion
-                    dist[ai + 1][bi] + 1),        // insertion
-                dist[ai][bi] + substitutionCost); // substitution
-        }
-    }
-    return dist[lenA][lenB];
+    return detail::levenshtein_pattern<MaxLength>(strA, false).distance(strB);
 };
 
+/**
+ * @brief Compute the Levenshtein distance through MaxLength, ignoring ASCII
+ * case. See levenshtein_distance
+ */
 template <size_t MaxLength>
 constexpr auto caseless_levenshtein_distance =
     [](std::string_view strA, std::string_view strB) -> int {
-    char buffA[MaxLength];
-    char buffB[MaxLength];
+    return detail::levenshtein_pattern<MaxLength>(strA, true).distance(strB);
+};
+
+/**
+ * @brief A name found by fuzzy matching: its index in declaration order, and
+ * its distance from the query
+ */
+struct fuzzy_match {
+    size_t index = 0;
+    int distance = 0;
+
+    constexpr bool operator==(fuzzy_match const& other) const noexcept {
+        return index == other.index && distance == other.distance;
+    }
+    constexpr bool operator!=(fuzzy_match const& other) const noexcept {
+        return !(*this == other);
+    }
+};
+
+/**
+ * @brief Up to K fuzzy matches, stored inline so that no memory is allocated.
+ * Matches are sorted by distance, and then by index.
+ *
+ * @tparam K the maximum number of matches
+ */
+template <size_t K>
+struct fuzzy_matches {
+    std::array<fuzzy_match, K> matches {};
+    size_t count = 0;
+
+    constexpr size_t size() const noexcept { return count; }
+    constexpr bool empty() const noexcept { return count == 0; }
+    constexpr fuzzy_match const* begin() const noexcept {
+        return matches.data();
+    }
+    constexpr fuzzy_match const* end() const noexcept {
+        return matches.data() + count;
+    }
+    constexpr fuzzy_match const& operator[](size_t i) const noexcept {
+        return matches[i];
+    }
+
+    /**
+     * @brief The largest distance that a new match could have and still be
+     * added. If the list is full, a match at this distance is only added if
+     * its index is lower than the last match
+     */
+    constexpr int threshold(int max_distance) const noexcept {
+        return count < K ? max_distance : matches[K - 1].distance;
+    }
 
-    size_t lenA = std::min(MaxLength, strA.size());
-    size_t lenB = std::min(MaxLength, strB.size());
+    /**
+     * @brief Add a match, keeping the list sorted. If the list is full, the
+     * last match is dropped. Returns false if the match wasn't added.
+     */
+    constexpr bool insert(fuzzy_match match) noexcept {
+        auto less = [](fuzzy_match const& a, fuzzy_match const& b) {
+            return a.distance != b.distance ? a.distance < b.distance
+                                            : a.index < b.index;
+        };
+        if constexpr (K == 0) {
+            return false;
+        } else {
+            if (count == K && !less(match, matches[K - 1])) {
+                return false;
+            }
+            size_t i = count < K ? count++ : K - 1;
+            for (; i > 0 && less(match, matches[i - 1]); i--) {
+                matches[i] = matches[i - 1];
+            }
+            matches[i] = match;
+            return true;
+        }
+    }
+};
+
+namespace detail {
+/**
+ * @brief An index over the lowercase bigrams (pairs of adjacent characters) in
+ * an enum's names, built at compile time. Bigrams are hashed into buckets, and
+ * each bucket lists the names containing a bigram in that bucket, along with
+ * how many times it occurs in each name.
+ *
+ * The index gives a lower bound on the distance from a query to each name, so
+ * that fuzzy_match_enum only has to compute the distance to names that could
+ * beat the best match found so far.
+ */
+template <class Enum>
+struct bigram_index {
+    constexpr static size_t size = num_states<Enum>;
 
-    for (size_t i = 0; i < lenA; i++) {
-        buffA[i] = detail::to_lower(strA[i]);
+    constexpr static size_t get_num_bigrams() noexcept {
+        size_t result = 0;
+        for (std::string_view name : enum_names<Enum>) {
+            result += name.size() > 0 ? name.size() - 1 : 0;
+        }
+        return result;
     }
-    for (size_t i = 0; i < lenB; i++) {
-        buffB[i] = detail::to_lower(strB[i]);
+    constexpr static size_t get_max_name_size() noexcept {
+        size_t result = 0;
+        for (std::string_view name : enum_names<Enum>) {
+            result = name.size() > result ? name.size() : result;
+        }
+        return result;
+    }
+    constexpr static size_t get_bucket_bits() noexcept {
+        size_t bits = 4;
+        while (bits < 12 && (size_t(1) << bits) < num_bigrams) {
+            bits++;
+        }
+        return bits;
+    }
+    constexpr static size_t num_bigrams = get_num_bigrams();
+    constexpr static size_t max_name_size = get_max_name_size();
+    constexpr static size_t bucket_bits = get_bucket_bits();
+    constexpr static size_t num_buckets = size_t(1) << bucket_bits;
+
+    using ordinal_type = uint_fit_t<size>;
+    using count_type = uint_fit_t<max_name_size>;
+
+    struct posting {
+        ordinal_type ordinal;
+        count_type count;
+    };
+
+    constexpr static size_t bucket_of(char a, char b) noexcept {
+        uint32_t bigram = uint32_t((unsigned char)to_lower(a)) << 8
+                        | uint32_t((unsigned char)to_lower(b));
+        return uint32_t(bigram * 0x9e3779b1u) >> (32 - bucket_bits);
+    }
+
+    // The postings for bucket i are postings[offsets[i]] through
+    // postings[offsets[i + 1]]. Each name appears at most once per bucket
+    std::array<uint_fit_t<num_bigrams>, num_buckets + 1> offsets {};
+    std::array<posting, num_bigrams> postings {};
+
+    constexpr bigram_index() {
+        std::array<size_t, num_buckets> last_name {};
+        for (size_t i = 0; i < num_buckets; i++) {
+            last_name[i] = size;
+        }
+        for (size_t i = 0; i < size; i++) {
+            std::string_view name = enum_names<Enum>[i];
+            for (size_t j = 1; j < name.size(); j++) {
+                size_t bucket = bucket_of(name[j - 1], name[j]);
+                if (last_name[bucket] != i) {
+                    last_name[bucket] = i;
+                    offsets[bucket + 1]++;
+                }
+            }
+        }
+        for (size_t i = 0; i < num_buckets; i++) {
+            offsets[i + 1] += offsets[i];
+            last_name[i] = size;
+        }
+        std::array<size_t, num_buckets> ends {};
+        for (size_t i = 0; i < num_buckets; i++) {
+            ends[i] = offsets[i];
+        }
+        for (size_t i = 0; i < size; i++) {
+            std::string_view name = enum_names<Enum>[i];
+            for (size_t j = 1; j < name.size(); j++) {
+                size_t bucket = bucket_of(name[j - 1], name[j]);
+                if (last_name[bucket] != i) {
+                    last_name[bucket] = i;
+                    postings[ends[bucket]++] = {ordinal_type(i), 0};
+                }
+                postings[ends[bucket] - 1].count++;
+            }
+        }
     }
-    return levenshtein_distance<MaxLength>(
-        std::string_view(buffA, lenA),
-        std::string_view(buffB, lenB));
 };
 
+template <class Enum>
+constexpr bigram_index<Enum> bigram_index_v {};
+
+/**
+ * @brief Find the K names closest to the given pattern, out of the names
+ * within max_distance. If two names have the same distance, the first one is
+ * preferred.
+ *
+ * The result is the same as computing the distance to every name, but names
+ * are visited in order of a lower bound on their distance, and the search
+ * stops once no remaining name can beat the matches found so far. The lower
+ * bound is the larger of the difference in length, and the bound given by
+ * counting shared bigrams: each edit changes at most two of the bigrams in a
+ * string. Distances are abandoned as soon as they exceed the current
+ * threshold.
+ *
+ * @param pattern the query, prepared for computing distances
+ * @param query the query. Must be truncated to MaxLength
+ * @param max_distance the largest distance a match may have
+ */
+template <class Enum, size_t K, size_t MaxLength>
+constexpr fuzzy_matches<K> fuzzy_search_index(
+    levenshtein_pattern<MaxLength> const& pattern,
+    std::string_view query,
+    int max_distance) {
+    using index_t = bigram_index<Enum>;
+    constexpr size_t size = index_t::size;
+    constexpr auto const& index = bigram_index_v<Enum>;
+    using ordinal_type = typename index_t::ordinal_type;
+    using bound_type = uint_fit_t<MaxLength>;
+    fuzzy_matches<K> result;
+    if constexpr (size == 0 || K == 0) {
+        return result;
+    } else {
+        // Sort the buckets of the query's bigrams, so that repeated bigrams
+        // are counted together
+        size_t num_bigrams = query.size() > 0 ? query.size() - 1 : 0;
+        uint16_t buckets[MaxLength > 0 ? MaxLength : 1] {};
+        for (size_t i = 0; i < num_bigrams; i++) {
+            auto bucket = uint16_t(index_t::bucket_of(query[i], query[i + 1]));
+            size_t j = i;
+            for (; j > 0 && buckets[j - 1] > bucket; j--) {
+                buckets[j] = buckets[j - 1];
+            }
+            buckets[j] = bucket;
+        }
+
+        // shared[i] is the number of bigrams shared with name i. Hash
+        // collisions can only make this larger, so the bound stays valid
+        typename index_t::count_type shared[size] {};
+        for (size_t i = 0; i < num_bigrams;) {
+            size_t bucket = buckets[i];
+            size_t count = 1;
+            for (i++; i < num_bigrams && buckets[i] == bucket; i++) {
+                count++;
+            }
+            for (size_t p = index.offsets[bucket];
+                 p < index.offsets[bucket + 1];
+                 p++) {
+                auto const& posting = index.postings[p];
+                shared[posting.ordinal] += std::min<size_t>(
+                    count,
+                    posting.count);
+            }
+        }
+
+        // Counting sort of the names by their lower bound
+        bound_type bounds[size] {};
+        size_t bound_counts[MaxLength + 2] {};
+        for (size_t i = 0; i < size; i++) {
+            size_t name_size = enum_names<Enum>[i].size();
+            size_t longer = std::max(name_size, query.size());
+            size_t shorter = std::min(name_size, query.size());
+            // Each string has size - 1 bigrams, and each edit changes at most
+            // two of them
+            size_t num_shared = shared[i];
+            size_t unshared = longer > num_shared + 1
+                                ? longer - 1 - num_shared
+                                : 0;
+            size_t bound = std::max(longer - shorter, (unshared + 1) / 2);
+            bounds[i] = bound_type(bound);
+            bound_counts[bound + 1]++;
+        }
+        for (size_t i = 0; i <= MaxLength; i++) {
+            bound_counts[i + 1] += bound_counts[i];
+        }
+        ordinal_type order[size] {};
+        for (size_t i = 0; i < size; i++) {
+            order[bound_counts[bounds[i]]++] = ordinal_type(i);
+        }
+
+        for (size_t i : order) {
+            int threshold = result.threshold(max_distance);
+            int bound = int(bounds[i]);
+            if (bound > threshold) {
+                break;
+            }
+            if (bound == threshold && result.count == K
+                && i > result[K - 1].index) {
+                continue;
+            }
+            int dist = pattern.distance(enum_names<Enum>[i], threshold);
+            if (dist <= threshold) {
+                result.insert({i, dist});
+            }
+        }
+        return result;
+    }
+}
+} // namespace detail
+
 /**
  * @brief Use fuzzy matching to find the index of the option closest to the
  * given value, from an array of options. If two options have the same distance,
@@ -102,25 +546,46 @@ constexpr size_t fuzzy_search(
  * given name. Compare names based on levenshtein distance. Index is
  * in declaration order, so if the return value is i you can get the
  * corresponding value with values[i] and the corresponding name with
- * names[i]. Converts inputs and names to lowercase by default.*/
+ * names[i]. Ignores ASCII case by default.*/
 template <class Enum>
 constexpr static auto fuzzy_match_enum = [](std::string_view name,
                                             bool use_lowercase = true) {
     using traits = enum_traits<Enum>;
     constexpr size_t MaxLength = detail::bit_ceil_minus_1(
         traits::max_name_length * 2);
-    char buff[MaxLength];
-    if (use_lowercase) {
-        size_t N = std::min(MaxLength, name.size());
-        for (size_t i = 0; i < N; i++) {
-            buff[i] = detail::to_lower(name[i]);
-        }
-        name = std::string_view(buff, N);
-    }
-    return fuzzy_search(
-        {use_lowercase ? traits::lowercase_names.data() : traits::names.data(),
-         traits::size},
+    name = name.substr(0, MaxLength);
+    // The name is the pattern, so its masks are only computed once
+    detail::levenshtein_pattern<MaxLength> pattern(name, use_lowercase);
+    auto best = detail::fuzzy_search_index<Enum, 1>(
+        pattern,
         name,
-        levenshtein_distance<MaxLength>);
+        std::numeric_limits<int>::max());
+    return best.empty() ? std::string_view::npos : best[0].index;
+};
+
+/**
+ * @brief Find up to K names closest to the given name, with a distance of at
+ * most max_distance. Matches are sorted by distance, and then by index in
+ * declaration order. This is useful for offering several suggestions when a
+ * user enters an unknown name.
+ *
+ * Nothing is allocated: matches are returned in a fixed-size array, and
+ * distances are computed a column at a time with one word per 64 characters,
+ * giving up on a name as soon as it can't make the list. Ignores ASCII case by
+ * default.
+ *
+ * @tparam Enum the enum to search
+ * @tparam K the maximum number of matches to return
+ */
+template <class Enum, size_t K>
+constexpr static auto fuzzy_match_enum_top = [](std::string_view name,
+                                                int max_distance,
+                                                bool use_lowercase = true) {
+    using traits = enum_traits<Enum>;
+    constexpr size_t MaxLength = detail::bit_ceil_minus_1(
+        traits::max_name_length * 2);
+    name = name.substr(0, MaxLength);
+    detail::levenshtein_pattern<MaxLength> pattern(name, use_lowercase);
+    return detail::fuzzy_search_index<Enum, K>(pattern, name, max_distance);
 };
 } // namespace nav
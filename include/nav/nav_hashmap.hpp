@@ -1,42 +1,205 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
 #include <string_view>
+#include <type_traits>
 
 namespace nav::detail {
-template <uint64_t initial_value, uint64_t mul>
-constexpr auto block8_hash = [](std::string_view sv) -> unsigned {
-    // A prime close to a power of 2 is chosen b/c modulo can be computed with
-    // shifts and additions. The compiler does this automatically.
-    constexpr uint64_t p = (uint64_t(1) << 61) - 1;
+constexpr bool is_constant_evaluated() noexcept {
+#if __cpp_lib_is_constant_evaluated >= 201811L
+    return std::is_constant_evaluated();
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_is_constant_evaluated();
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Convert the ASCII uppercase letters in a block of 8 bytes to
+ * lowercase, leaving every other byte unchanged.
+ *
+ * Adding to the low 7 bits of each byte can't carry into the next byte, so the
+ * high bit of each byte of ge_a is set when the byte is at least 'A', and the
+ * high bit of each byte of gt_z is set when the byte is greater than 'Z'.
+ * Shifting the high bit of each uppercase byte right by 2 gives 0x20, which is
+ * the difference between uppercase and lowercase.
+ */
+constexpr uint64_t ascii_to_lower_block(uint64_t block) noexcept {
+    constexpr uint64_t ones = 0x0101010101010101;
+    constexpr uint64_t high_bits = 0x80 * ones;
+    uint64_t low_bits = block & ~high_bits;
+    uint64_t ge_a = low_bits + (0x80 - 'A') * ones;
+    uint64_t gt_z = low_bits + (0x7f - 'Z') * ones;
+    uint64_t is_upper = ge_a & ~gt_z & ~block & high_bits;
+    return block | (is_upper >> 2);
+}
+
+constexpr uint64_t load_byte(char const* str, size_t i) noexcept {
+    return uint64_t((unsigned char)str[i]) << (i * 8);
+}
+
+// Loads 8 bytes in little-endian order. At run time on little-endian targets
+// this is a single unaligned load. During constant evaluation, and on
+// big-endian targets, the bytes are assembled one at a time. They're loaded as
+// unsigned, so that a negative char can't spill into the other bytes of the
+// block. Both give the same result
+constexpr uint64_t load_block8(char const* str) noexcept {
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if (!is_constant_evaluated()) {
+        uint64_t block {};
+        std::memcpy(&block, str, 8);
+        return block;
+    }
+#endif
+    return load_byte(str, 0) | load_byte(str, 1) | load_byte(str, 2)
+         | load_byte(str, 3) | load_byte(str, 4) | load_byte(str, 5)
+         | load_byte(str, 6) | load_byte(str, 7);
+}
+
+constexpr uint64_t load_block4(char const* str) noexcept {
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if (!is_constant_evaluated()) {
+        uint32_t block {};
+        std::memcpy(&block, str, 4);
+        return block;
+    }
+#endif
+    return load_byte(str, 0) | load_byte(str, 1) | load_byte(str, 2)
+         | load_byte(str, 3);
+}
+
+/**
+ * @brief Load the last n bytes of a string (where 0 < n < 8) in little-endian
+ * order, as if they were loaded one at a time.
+ *
+ * @param str the first of the n bytes
+ * @param n the number of bytes to load
+ * @param size the size of the whole string. If it's at least 8, the bytes are
+ * taken from the top of an 8-byte load ending at the end of the string.
+ * Otherwise, two loads which overlap in the middle are combined.
+ */
+constexpr uint64_t load_tail(char const* str, size_t n, size_t size) noexcept {
+    if (size >= 8) {
+        return load_block8(str + n - 8) >> (64 - 8 * n);
+    } else if (n >= 4) {
+        return load_block4(str) | load_block4(str + n - 4) << (8 * (n - 4));
+    } else {
+        return load_byte(str, 0) | load_byte(str, n / 2) | load_byte(str, n - 1);
+    }
+}
+
+// The hash is computed modulo this prime. A number of the form 2^61 - 1 can be
+// reduced with a mask, a shift, and an add
+constexpr uint64_t mersenne_61 = (uint64_t(1) << 61) - 1;
+
+// Partially reduces x modulo mersenne_61, giving a result below 2^61 + 8, which
+// is congruent to x. This is cheaper than computing x % mersenne_61, so we only
+// fully reduce the hash once, at the end
+constexpr uint64_t fold_mersenne_61(uint64_t x) noexcept {
+    return (x & mersenne_61) + (x >> 61);
+}
+
+constexpr uint64_t reduce_mersenne_61(uint64_t x) noexcept {
+    x = fold_mersenne_61(x);
+    return x >= mersenne_61 ? x - mersenne_61 : x;
+}
+
+template <bool IgnoreCase>
+constexpr uint64_t block8_hash_impl(
+    std::string_view sv,
+    uint64_t initial_value,
+    uint64_t mul) {
+    // h stays below 2^61 + 8 between blocks. For multipliers above 7, h * mul
+    // can wrap around, so the result is a hash of the string rather than an
+    // exact polynomial modulo the prime
     uint64_t h = initial_value;
 
     char const* str = sv.data();
     size_t size = sv.size();
 
     for (char const* end = str + size - size % 8; str != end; str += 8) {
-        uint64_t item = uint64_t(str[0])       //
-                      | uint64_t(str[1]) << 8  //
-                      | uint64_t(str[2]) << 16 //
-                      | uint64_t(str[3]) << 24 //
-                      | uint64_t(str[4]) << 32 //
-                      | uint64_t(str[5]) << 40 //
-                      | uint64_t(str[6]) << 48 //
-                      | uint64_t(str[7]) << 56;
-        h = ((h * mul) + item) % p;
-    }
-
-    // remaining bytes that didn't fit in a block of 4
-    int n = size % 8;
+        uint64_t item = load_block8(str);
+        if constexpr (IgnoreCase) {
+            item = ascii_to_lower_block(item);
+        }
+        h = fold_mersenne_61(h * mul + item);
+    }
+
+    // remaining bytes that didn't fit in a block of 8
+    size_t n = size % 8;
     if (n > 0) {
-        uint64_t item = 0;
-        for (int i = 0; i < n; i++) {
-            item |= uint64_t(str[i]) << (i * 8);
+        uint64_t item = load_tail(str, n, size);
+        if constexpr (IgnoreCase) {
+            item = ascii_to_lower_block(item);
+        }
+        h = fold_mersenne_61(h * mul + item);
+    }
+
+    return reduce_mersenne_61(h);
+}
+
+/**
+ * @brief Hash a string 8 bytes at a time, with an explicit initial value. The
+ * initial value acts as a seed, which allows hash tables to search for a seed
+ * with good properties at compile time.
+ *
+ * @param sv the string to hash
+ * @param initial_value the initial value (or seed) of the hash
+ * @param mul the multiplier applied to the hash before each block is added
+ * @return uint64_t the hash, which is always less than 2^61 - 1
+ */
+constexpr uint64_t block8_hash_seeded(
+    std::string_view sv,
+    uint64_t initial_value,
+    uint64_t mul = 31) {
+    return block8_hash_impl<false>(sv, initial_value, mul);
+}
+
+/**
+ * @brief Same as block8_hash_seeded, but ASCII letters are lowercased as each
+ * block is hashed, so strings which only differ in case have the same hash.
+ */
+constexpr uint64_t block8_hash_ignore_case_seeded(
+    std::string_view sv,
+    uint64_t initial_value,
+    uint64_t mul = 31) {
+    return block8_hash_impl<true>(sv, initial_value, mul);
+}
+
+/**
+ * @brief Check if two strings are equal, ignoring the case of ASCII letters.
+ * Compares 8 bytes at a time, so no lowercase copy of either string is needed.
+ */
+constexpr bool equal_ignore_case(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    size_t size = a.size();
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t block_a = ascii_to_lower_block(load_block8(a.data() + i));
+        uint64_t block_b = ascii_to_lower_block(load_block8(b.data() + i));
+        if (block_a != block_b) {
+            return false;
         }
-        h = ((h * mul) + item) % p;
     }
+    for (; i < size; i++) {
+        char ch_a = a[i];
+        char ch_b = b[i];
+        ch_a = 'A' <= ch_a && ch_a <= 'Z' ? ch_a - 'A' + 'a' : ch_a;
+        ch_b = 'A' <= ch_b && ch_b <= 'Z' ? ch_b - 'A' + 'a' : ch_b;
+        if (ch_a != ch_b) {
+            return false;
+        }
+    }
+    return true;
+}
 
-    return unsigned(h);
+template <uint64_t initial_value, uint64_t mul>
+constexpr auto block8_hash = [](std::string_view sv) -> unsigned {
+    return unsigned(block8_hash_seeded(sv, initial_value, mul));
 };
 
 constexpr auto hash_sv = block8_hash<0, 31>;
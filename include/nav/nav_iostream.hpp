@@ -1,16 +1,40 @@
 #pragma once
 #include <nav/nav_core.hpp>
 #include <ostream>
+#include <type_traits>
 
 namespace nav {
-template <nav_enum Enum>
+/**
+ * @brief Print a value in the form "Color::Red". Values of flag enums are
+ * printed one flag at a time (eg, "Access::Read|Access::Write"), and values
+ * without a name are printed as "Color(5)". Names are written to the stream
+ * directly, without building a temporary string.
+ */
+template <class Enum, class = std::enable_if_t<is_nav_enum<Enum>>>
 std::ostream& operator<<(std::ostream& os, Enum value) {
-    using traits = enum_traits<Enum>;
-    if (auto name = traits::get_name(value)) {
-        return os << traits::type_name << "::" << *name;
+    using info = enum_type_info<Enum>;
+    bool is_first = true;
+    auto print_name = [&](std::string_view name) {
+        if (!is_first) {
+            os << '|';
+        }
+        is_first = false;
+        os << info::type_name << "::" << name;
+    };
+    bool has_name = false;
+    if constexpr (is_flag_enum<Enum>) {
+        has_name = for_each_flag_name(value, print_name);
     } else {
-        return os << traits::type_name << "("
-                  << typename traits::base_type(value) << ")";
+        std::string_view name;
+        has_name = name_of(value, name);
+        if (has_name) {
+            print_name(name);
+        }
     }
+    if (!has_name) {
+        os << info::type_name << '('
+           << +std::underlying_type_t<Enum>(value) << ')';
+    }
+    return os;
 }
 } // namespace nav
@@ -1,14 +1,77 @@
 #pragma once
-#include <cmath>
 #include <fmt/core.h>
 #include <fmt/format.h>
+#include <nav/nav_charconv.hpp>
 #include <nav/nav_core.hpp>
 #include <type_traits>
 
-template <nav::nav_enum Enum>
-struct fmt::formatter<Enum> : private fmt::formatter<std::string_view> {
+namespace nav::detail {
+// The size of a block holding every name of an enum with a prefix and "::"
+// in front of it
+template <class Enum>
+constexpr size_t prefixed_block_size(std::string_view prefix) noexcept {
+    return enum_name_list<Enum>::block_type::block_size()
+         + num_states<Enum> * (prefix.size() + 2);
+}
+
+// The names of an enum as written by the {:Q} presentation (Type::Name) when
+// FullyQualified is false, and by the {:F} presentation (ns::Type::Name) when
+// it's true. They're built at compile time, so formatting a named value
+// doesn't need to join strings
+template <class Enum, bool FullyQualified>
+struct prefixed_names {
+    constexpr static std::string_view prefix =
+        FullyQualified ? enum_type_info<Enum>::qualified_type_name
+                       : enum_type_info<Enum>::type_name;
+    using block_type = string_block<
+        num_states<Enum>,
+        prefixed_block_size<Enum>(prefix)>;
+    using offset_type = typename block_type::offset_type;
+
+    constexpr static block_type block {[](block_type& dest) {
+        size_t offset = 0;
+        auto append = [&](std::string_view str) {
+            for (char ch : str) {
+                dest.data[offset++] = ch;
+            }
+        };
+        for (size_t i = 0; i < num_states<Enum>; i++) {
+            dest.offsets[i] = offset_type(offset);
+            append(prefix);
+            append("::");
+            append(enum_names<Enum>[i]);
+            // Each name is followed by a null terminator, if those are enabled
+            offset += NAV_ADD_NULL_TERMINATORS;
+        }
+        dest.offsets[num_states<Enum>] = offset_type(offset);
+    }};
+};
+} // namespace nav::detail
+
+template <class Enum>
+struct fmt::formatter<Enum, char, std::enable_if_t<nav::is_nav_enum<Enum>>>
+  : private fmt::formatter<std::string_view> {
    private:
     using super = fmt::formatter<std::string_view>;
+    using info = nav::enum_type_info<Enum>;
+
+    constexpr static size_t get_max_name_size() noexcept {
+        size_t result = 0;
+        for (std::string_view name : nav::enum_names<Enum>) {
+            result = name.size() > result ? name.size() : result;
+        }
+        return result;
+    }
+    // Values of flag enums may be written as one name per bit
+    constexpr static size_t max_names = nav::is_flag_enum<Enum>
+                                          ? sizeof(Enum) * 8
+                                          : 1;
+    // Large enough for the longest output: max_names names, each with the
+    // type attached and a separator, or the type followed by an integer
+    constexpr static size_t buffer_size =
+        max_names
+            * (info::qualified_type_name.size() + 3 + get_max_name_size())
+        + info::qualified_type_name.size() + 32;
 
     enum Presentation : char {
         // Just the name of the value
@@ -63,77 +126,66 @@ struct fmt::formatter<Enum> : private fmt::formatter<std::string_view> {
         return super::parse(ctx);
     }
 
-    // Formats the point p using the parsed format specification (presentation)
-    // stored in this formatter.
-    template <typename FormatContext>
-    auto format(const Enum& value, FormatContext& ctx) -> decltype(ctx.out()) {
-        using traits = nav::enum_traits<Enum>;
-        using base_type = typename traits::base_type;
-        switch (enumFmt) {
-            default: // If the presentation format is invalid, use this
-            case Name: {
-                if (auto name = traits::get_name(value)) {
-                    return super::format(*name, ctx);
-                } else {
-                    char buffer[traits::type_name.size() + 32] {};
-                    auto base_val = base_type(value);
+    template <bool FullyQualified>
+    using prefixed_names = nav::detail::prefixed_names<Enum, FullyQualified>;
 
-                    char* end = fmt::format_to(
-                        buffer,
-                        "{}({})",
-                        traits::type_name,
-                        base_val);
-                    return super::format(std::string_view(buffer, end), ctx);
-                }
-            } break;
-            case QualifiedName: {
-                constexpr size_t buff_size = traits::type_name.size()
-                                           + nav::detail::max(
-                                                 size_t(32),
-                                                 traits::max_name_length + 2);
-                char buffer[buff_size] {};
-                char* end;
-                if (auto name = traits::get_name(value)) {
-                    end = fmt::format_to(
-                        buffer,
-                        "{}::{}",
-                        traits::type_name,
-                        *name);
-                } else {
-                    auto base_val = base_type(value);
+    // The name of the value with the given ordinal, in the parsed presentation
+    constexpr std::string_view name_at(size_t ordinal) const noexcept {
+        switch (enumFmt) {
+            case QualifiedName: return prefixed_names<false>::block[ordinal];
+            case FullName: return prefixed_names<true>::block[ordinal];
+            default: return nav::enum_names<Enum>[ordinal];
+        }
+    }
 
-                    end = fmt::format_to(
-                        buffer,
-                        "{}({})",
-                        traits::type_name,
-                        base_val);
-                }
-                return super::format(std::string_view(buffer, end), ctx);
-            } break;
-            case FullName: {
-                constexpr size_t buff_size = traits::qualified_type_name.size()
-                                           + nav::detail::max(
-                                                 size_t(32),
-                                                 traits::max_name_length + 2);
-                char buffer[buff_size] {};
-                char* end;
-                if (auto name = traits::get_name(value)) {
-                    end = fmt::format_to(
-                        buffer,
-                        "{}::{}",
-                        traits::qualified_type_name,
-                        *name);
-                } else {
-                    auto base_val = base_type(value);
+    // Formats the value using the parsed format specification. Named values
+    // are looked up in a block of names built for the presentation, and passed
+    // straight to the padding logic. Values of flag enums without a name of
+    // their own, and values without a name, are written to a buffer on the
+    // stack first, so nothing is allocated
+    template <typename FormatContext>
+    FMT_CONSTEXPR auto format(const Enum& value, FormatContext& ctx) const
+        -> decltype(ctx.out()) {
+        size_t ordinal = nav::ordinal_of(value);
+        if (ordinal < nav::num_states<Enum>) {
+            return super::format(name_at(ordinal), ctx);
+        }
 
-                    end = fmt::format_to(
-                        buffer,
-                        "{}({})",
-                        traits::qualified_type_name,
-                        base_val);
-                }
-                return super::format(std::string_view(buffer, end), ctx);
-            } break;
+        using base_type = std::underlying_type_t<Enum>;
+        std::string_view type_name = enumFmt == FullName
+                                       ? info::qualified_type_name
+                                       : info::type_name;
+        char buffer[buffer_size] {};
+        char* end = buffer;
+        auto append = [&end](std::string_view str) {
+            for (char ch : str) {
+                *end++ = ch;
+            }
+        };
+        auto append_name = [&](std::string_view name) {
+            if (end != buffer) {
+                append("|");
+            }
+            if (enumFmt != Name) {
+                append(type_name);
+                append("::");
+            }
+            append(name);
+        };
+        bool has_name = false;
+        if constexpr (nav::is_flag_enum<Enum>) {
+            has_name = nav::detail::for_each_flag_bit_name(value, append_name);
+        }
+        if (!has_name) {
+            append(type_name);
+            append("(");
+            end = nav::detail::integer_to_chars(
+                      end,
+                      buffer + buffer_size,
+                      +base_type(value))
+                      .ptr;
+            append(")");
         }
+        return super::format(std::string_view(buffer, end - buffer), ctx);
     }
 };
@@ -13,25 +13,11 @@ struct lowercase_enum_name_list : enum_type_info<Enum> {
     using block_type = typename enum_name_list<Enum>::block_type;
 
    private:
-    constexpr static block_type name_block {[](block_type& dest) {
-        block_type const& source = enum_name_list<Enum>::get_name_block();
-        {
-            size_t N = source.block_size();
-            for (size_t i = 0; i < N; i++) {
-                char ch = source.data[i];
-                dest.data[i] = 'A' <= ch && ch <= 'Z' ? ch - 'A' + 'a' : ch;
-            }
-        }
-        {
-            size_t N = source.size();
-            for (size_t i = 0; i <= N; i++) {
-                dest.offsets[i] = source.offsets[i];
-            }
-        }
-    }};
+    constexpr static block_type const& name_block = detail::
+        lowercase_name_block<Enum>;
 
    public:
-    using iterator = string_block_iterator;
+    using iterator = typename block_type::iterator;
     using const_iterator = iterator;
     constexpr iterator begin() const noexcept {
         return name_block.begin();
@@ -0,0 +1,18 @@
+#include <cstdio>
+#include <nav/core.hpp>
+
+#ifndef TEST_VALUES
+#define NUM_VALUES 1
+#define TEST_VALUES E0
+#endif
+nav_declare_enum(TestEnum, int, TEST_VALUES);
+
+using traits = nav::enum_traits<TestEnum>;
+static_assert(NUM_VALUES == traits::size);
+
+int main(int argc, char** argv) {
+    // Look up a name and a value, so that the maps in enum_traits are used
+    std::string_view name = traits::get_name(TestEnum(argc), "<unnamed>");
+    auto value = traits::get_value(argc > 1 ? argv[1] : "E0");
+    printf("%.*s %d\n", int(name.size()), name.data(), value ? int(*value) : -1);
+}
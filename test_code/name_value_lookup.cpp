@@ -0,0 +1,16 @@
+#include <cstdio>
+#include <nav/nav_core.hpp>
+
+#ifndef TEST_VALUES
+#define NUM_VALUES 1
+#define TEST_VALUES E0
+#endif
+nav_declare_enum(TestEnum, int, TEST_VALUES);
+
+int main(int argc, char** argv) {
+    // Look up a name and a value, so that the indices used by nav::name_of and
+    // nav::value_of are instantiated
+    std::string_view name = nav::name_of(TestEnum(argc)).value_or("<unnamed>");
+    auto value = nav::value_of<TestEnum>(argc > 1 ? argv[1] : "E0");
+    printf("%.*s %d\n", int(name.size()), name.data(), value ? int(*value) : -1);
+}
@@ -1,30 +1,29 @@
-#include <algorithm>
-#include <cassert>
 #include <catch2/catch_test_macros.hpp>
 #include <fmt/core.h>
-#include <fmt/ranges.h>
 #include <nav/nav_charconv.hpp>
 #include <random>
-#include <vector>
-
-std::string_view flp_test(
-    nav::view<std::string_view> prefixes,
-    std::string_view string) {
-    auto* result = nav::detail::find_longest_prefix(
-        prefixes,
-        string,
-        [](std::string_view sv) { return sv; });
-    if (result) {
-        return *result;
-    } else {
-        return {};
-    }
-}
-std::string_view flp_reference(
-    nav::view<std::string_view> prefixes,
-    std::string_view string) {
+#include <string>
+
+// Names which are prefixes of each other, so that from_chars has to find the
+// longest name that matches
+nav_declare_enum(
+    Prefixes,
+    int,
+    a,
+    ab,
+    abc,
+    abd,
+    b,
+    ba,
+    bab,
+    bacd,
+    c,
+    dcba);
+
+// Finds the longest name that's a prefix of string by checking every name
+std::string_view longest_prefix_reference(std::string_view string) {
     std::string_view best_prefix {};
-    for (auto prefix : prefixes) {
+    for (auto prefix : nav::enum_names<Prefixes>) {
         if (prefix.size() > best_prefix.size()
             && string.substr(0, prefix.size()) == prefix) {
             best_prefix = prefix;
@@ -33,25 +32,6 @@ std::string_view flp_reference(
     return best_prefix;
 }
 
-template <class RNG>
-std::vector<std::string_view> split_random(
-    std::string_view source,
-    RNG&& rng,
-    int min_len,
-    int max_len) {
-    std::vector<std::string_view> segments;
-
-    std::uniform_int_distribution<> dist(min_len, max_len);
-
-    while (source.size() > max_len) {
-        int len = dist(rng);
-        segments.push_back(source.substr(0, len));
-        size_t old_len = source.size();
-        source.remove_prefix(len);
-        assert(source.size() < old_len);
-    }
-    return segments;
-}
 template <class RNG>
 std::string random_string(size_t length, RNG&& rng, char min, char max) {
     std::string s(length, '\0');
@@ -63,23 +43,206 @@ std::string random_string(size_t length, RNG&& rng, char min, char max) {
 
     return s;
 }
-TEST_CASE("Test find_longest_prefix", "[charconv]") {
+TEST_CASE("Test from_chars finds the longest prefix", "[charconv]") {
     std::mt19937_64 gen;
-    std::string source = random_string(1000, gen, 'a', 'e');
-    fmt::print("Created source\n");
-    auto prefixes = split_random(source, gen, 3, 8);
-    fmt::print("Split random\n");
+    for (int i = 0; i < 1000; i++) {
+        std::string search_string = random_string(gen() % 8, gen, 'a', 'e');
+        auto expected = longest_prefix_reference(search_string);
 
-    std::sort(prefixes.begin(), prefixes.end());
-    auto prefix_view = nav::view {prefixes.data(), prefixes.size()};
+        INFO(fmt::format("Search string = {}", search_string));
+        char const* first = search_string.data();
+        char const* last = first + search_string.size();
+        Prefixes value {};
+        auto result = nav::from_chars(first, last, value);
+        if (expected.empty()) {
+            REQUIRE(result.ec == std::errc::invalid_argument);
+            REQUIRE(result.ptr == first);
+        } else {
+            REQUIRE(result.ec == std::errc {});
+            REQUIRE(result.ptr == first + expected.size());
+            REQUIRE(nav::name_of(value) == expected);
+        }
+    }
+}
 
-    for (int i = 0; i < 20; i++) {
-        std::string search_string = random_string(30, gen, 'a', 'e');
+nav_declare_enum(Planet, short, Mercury = 1, Venus, Earth, Mars);
 
-        INFO(fmt::format("Search string = {}", search_string));
-        INFO(fmt::format("{}", prefix_view));
-        REQUIRE(
-            flp_test(prefix_view, search_string)
-            == flp_reference(prefix_view, search_string));
+namespace charconv_test {
+enum class UnknownEnum { A, B };
+}
+
+// Bit 0x08 has no name, and Owner is a prefix of OwnerWrite
+nav_declare_flag_enum(
+    OpenMode,
+    unsigned,
+    In = 1,
+    Out = 2,
+    Append = 4,
+    Owner = 0x10,
+    OwnerWrite = 0x20,
+    InOut = In | Out);
+
+template <class Enum>
+std::string to_chars_string(
+    Enum value,
+    nav::name_style style = nav::name_style::bare) {
+    char buffer[64];
+    auto result = nav::to_chars(buffer, buffer + sizeof(buffer), value, style);
+    REQUIRE(result.ec == std::errc {});
+    return std::string(buffer, result.ptr);
+}
+
+// Writes a value to a buffer in a constant expression, and returns whether
+// the result matches the expected string
+template <class Enum>
+constexpr bool to_chars_matches(
+    Enum value,
+    nav::name_style style,
+    std::string_view expected) {
+    char buffer[64] {};
+    auto result = nav::to_chars(buffer, buffer + sizeof(buffer), value, style);
+    return result.ec == std::errc {}
+        && std::string_view(buffer, result.ptr - buffer) == expected;
+}
+
+TEST_CASE("Test to_chars", "[charconv]") {
+    using nav::name_style;
+    REQUIRE(to_chars_string(Planet::Earth) == "Earth");
+    REQUIRE(
+        to_chars_string(Planet::Mars, name_style::qualified)
+        == "Planet::Mars");
+    REQUIRE(
+        to_chars_string(Planet::Venus, name_style::full) == "Planet::Venus");
+
+    // Values without a name are written as integers
+    REQUIRE(to_chars_string(Planet(-12)) == "-12");
+    REQUIRE(to_chars_string(Planet(9), name_style::qualified) == "Planet(9)");
+    REQUIRE(to_chars_string(charconv_test::UnknownEnum::B) == "1");
+    REQUIRE(
+        to_chars_string(charconv_test::UnknownEnum::A, name_style::full)
+        == "charconv_test::UnknownEnum(0)");
+
+    // Output that doesn't fit is reported as value_too_large
+    for (auto style :
+         {name_style::bare, name_style::qualified, name_style::full}) {
+        char buffer[12];
+        for (size_t size = 0; size <= sizeof(buffer); size++) {
+            for (Planet value : {Planet::Mercury, Planet(-12345)}) {
+                auto expected = to_chars_string(value, style);
+                auto result = nav::to_chars(
+                    buffer,
+                    buffer + size,
+                    value,
+                    style);
+                if (expected.size() <= size) {
+                    REQUIRE(result.ec == std::errc {});
+                    REQUIRE(std::string(buffer, result.ptr) == expected);
+                } else {
+                    REQUIRE(result.ec == std::errc::value_too_large);
+                    REQUIRE(result.ptr == buffer + size);
+                }
+            }
+        }
+    }
+
+    STATIC_REQUIRE(to_chars_matches(Planet::Mars, name_style::bare, "Mars"));
+    STATIC_REQUIRE(
+        to_chars_matches(Planet::Mars, name_style::qualified, "Planet::Mars"));
+    STATIC_REQUIRE(
+        to_chars_matches(Planet(-7), name_style::qualified, "Planet(-7)"));
+}
+
+// Parses every name in text, where names aren't separated by anything
+template <class Enum>
+constexpr auto tokenize(std::string_view text) -> std::array<Enum, 4> {
+    std::array<Enum, 4> values {};
+    char const* first = text.data();
+    char const* last = first + text.size();
+    for (auto& value : values) {
+        first = nav::from_chars(first, last, value).ptr;
+    }
+    return values;
+}
+
+TEST_CASE("Test from_chars on names followed by text", "[charconv]") {
+    constexpr auto planets = tokenize<Planet>("MarsEarthMercuryVenus");
+    STATIC_REQUIRE(planets[0] == Planet::Mars);
+    STATIC_REQUIRE(planets[1] == Planet::Earth);
+    STATIC_REQUIRE(planets[2] == Planet::Mercury);
+    STATIC_REQUIRE(planets[3] == Planet::Venus);
+
+    std::string_view text = "abdcbababc";
+    auto prefixes = tokenize<Prefixes>(text);
+    REQUIRE(prefixes[0] == Prefixes::abd);
+    REQUIRE(prefixes[1] == Prefixes::c);
+    REQUIRE(prefixes[2] == Prefixes::bab);
+    REQUIRE(prefixes[3] == Prefixes::abc);
+
+    Planet value = Planet::Earth;
+    std::string_view pluto = "Pluto";
+    auto result = nav::from_chars(pluto.data(), pluto.data() + 5, value);
+    REQUIRE(result.ec == std::errc::invalid_argument);
+    REQUIRE(result.ptr == pluto.data());
+    REQUIRE(value == Planet::Earth);
+}
+
+TEST_CASE("Test to_chars and from_chars on flags", "[charconv][flags]") {
+    using nav::name_style;
+    using M = OpenMode;
+    REQUIRE(to_chars_string(M::InOut) == "InOut");
+    REQUIRE(to_chars_string(M::In | M::Append) == "In|Append");
+    REQUIRE(
+        to_chars_string(M::Out | M::Owner, name_style::qualified)
+        == "OpenMode::Out|OpenMode::Owner");
+    // Values with an unnamed bit are written as integers
+    REQUIRE(to_chars_string(M::In | M(8)) == "9");
+    REQUIRE(to_chars_string(M(0), name_style::qualified) == "OpenMode(0)");
+    STATIC_REQUIRE(
+        to_chars_matches(M::Append | M::Out, name_style::bare, "Out|Append"));
+
+    // Output that doesn't fit is reported as value_too_large
+    char buffer[16];
+    std::string expected = "Out|Append|Owner";
+    for (size_t size = 0; size <= sizeof(buffer); size++) {
+        auto result = nav::to_chars(
+            buffer,
+            buffer + size,
+            M::Out | M::Append | M::Owner);
+        if (size < expected.size()) {
+            REQUIRE(result.ec == std::errc::value_too_large);
+        } else {
+            REQUIRE(std::string(buffer, result.ptr) == expected);
+        }
     }
+
+    // Parsing stops at the first character that doesn't continue the flags
+    auto parse = [](std::string_view text, size_t expected_size) {
+        M value {};
+        auto result = nav::from_chars(
+            text.data(),
+            text.data() + text.size(),
+            value);
+        INFO("Text: " << text);
+        REQUIRE(result.ec == std::errc {});
+        REQUIRE(size_t(result.ptr - text.data()) == expected_size);
+        return value;
+    };
+    REQUIRE(parse("In|Append", 9) == (M::In | M::Append));
+    REQUIRE(parse("InOut|Owner", 11) == (M::InOut | M::Owner));
+    REQUIRE(parse("Owner|OwnerWrite", 16) == (M::Owner | M::OwnerWrite));
+    REQUIRE(parse("OwnerWriteIn", 10) == M::OwnerWrite);
+    REQUIRE(parse("Out|", 3) == M::Out);
+    REQUIRE(parse("Out|x", 3) == M::Out);
+    REQUIRE(parse("Out||In", 3) == M::Out);
+    REQUIRE(parse("Out|In|Ow", 6) == M::InOut);
+
+    // Other enums stop at the '|'
+    Planet planet {};
+    std::string_view planets = "Mars|Earth";
+    auto result = nav::from_chars(
+        planets.data(),
+        planets.data() + planets.size(),
+        planet);
+    REQUIRE(result.ptr == planets.data() + 4);
+    REQUIRE(planet == Planet::Mars);
 }
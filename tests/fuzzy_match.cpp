@@ -1,9 +1,11 @@
 #include "nav/nav_fuzzy_match.hpp"
+#include <algorithm>
 #include <catch2/catch_test_macros.hpp>
 #include <fmt/core.h>
 #include <nav/nav_core.hpp>
 #include <random>
 #include <string>
+#include <vector>
 
 // clang-format off
 nav_declare_enum(
@@ -40,6 +42,18 @@ nav_declare_enum(
     Browse, Issue, Range, Seller, Court);
 // clang-format on
 
+// Names with repeated bigrams, and names that differ only in case
+nav_declare_enum(
+    Repetitive,
+    int,
+    aaaa,
+    AAAA,
+    abab,
+    baba,
+    abba,
+    aaaaaaaaaaaaaaaaaaaaaaaaaaaaaab,
+    x);
+
 TEST_CASE("Fuzzy mach single-character misspellings", "[find_fuzzy]") {
     using traits = nav::enum_traits<CommonWords>;
 
@@ -141,3 +155,243 @@ TEST_CASE("Fuzzy mach two-character misspellings", "[find_fuzzy]") {
         REQUIRE(distance_metric(str, traits::names[found_i]) <= 2);
     }
 }
+
+// Reference implementation, filling in the whole distance matrix
+static int matrix_levenshtein_distance(std::string_view a, std::string_view b) {
+    std::vector<int> dist((a.size() + 1) * (b.size() + 1));
+    auto at = [&](size_t ai, size_t bi) -> int& {
+        return dist[ai * (b.size() + 1) + bi];
+    };
+    for (size_t ai = 0; ai <= a.size(); ai++) {
+        at(ai, 0) = int(ai);
+    }
+    for (size_t bi = 0; bi <= b.size(); bi++) {
+        at(0, bi) = int(bi);
+    }
+    for (size_t ai = 0; ai < a.size(); ai++) {
+        for (size_t bi = 0; bi < b.size(); bi++) {
+            at(ai + 1, bi + 1) = std::min(
+                std::min(at(ai, bi + 1) + 1, at(ai + 1, bi) + 1),
+                at(ai, bi) + int(a[ai] != b[bi]));
+        }
+    }
+    return at(a.size(), b.size());
+}
+
+TEST_CASE("Levenshtein distance matches the full matrix", "[find_fuzzy]") {
+    STATIC_REQUIRE(nav::levenshtein_distance<15>("kitten", "sitting") == 3);
+    STATIC_REQUIRE(
+        nav::caseless_levenshtein_distance<15>("KiTten", "kitTEN") == 0);
+    REQUIRE(nav::levenshtein_distance<15>("", "abc") == 3);
+    REQUIRE(nav::levenshtein_distance<15>("abc", "") == 3);
+    REQUIRE(nav::levenshtein_distance<15>("", "") == 0);
+
+    // Both strings are truncated to MaxLength
+    REQUIRE(nav::levenshtein_distance<3>("abcdef", "abcxyz") == 0);
+    REQUIRE(nav::levenshtein_distance<3>("abcdef", "ab") == 1);
+
+    std::mt19937_64 rng;
+    // A small alphabet, so that there are plenty of matching characters
+    std::uniform_int_distribution<int> letter_dist(0, 5);
+    // Lengths span one, two, and three blocks of 64 characters
+    std::uniform_int_distribution<size_t> length_dist(0, 150);
+    auto random_string = [&] {
+        std::string str(length_dist(rng), ' ');
+        for (char& ch : str) {
+            int letter = letter_dist(rng);
+            ch = letter < 3 ? 'a' + letter : 'A' + letter - 3;
+        }
+        return str;
+    };
+    auto to_lower = [](std::string str) {
+        for (char& ch : str) {
+            ch = nav::detail::to_lower(ch);
+        }
+        return str;
+    };
+    for (int i = 0; i < 500; i++) {
+        std::string a = random_string();
+        std::string b = random_string();
+        INFO("a = '" << a << "'\nb = '" << b << "'");
+        REQUIRE(
+            nav::levenshtein_distance<255>(a, b)
+            == matrix_levenshtein_distance(a, b));
+        REQUIRE(
+            nav::caseless_levenshtein_distance<255>(a, b)
+            == matrix_levenshtein_distance(to_lower(a), to_lower(b)));
+        REQUIRE(
+            nav::levenshtein_distance<100>(a, b)
+            == matrix_levenshtein_distance(
+                std::string_view(a).substr(0, 100),
+                std::string_view(b).substr(0, 100)));
+    }
+}
+
+TEST_CASE("Bounded Levenshtein distance gives up early", "[find_fuzzy]") {
+    using pattern = nav::detail::levenshtein_pattern<255>;
+    // Every cell of the column for "cd" exceeds 1, before the last row does
+    STATIC_REQUIRE(pattern("abcd", false).distance("cdab", 1) == 2);
+    STATIC_REQUIRE(pattern("abcd", false).distance("cdab", 2) == 3);
+    STATIC_REQUIRE(pattern("abcd", false).distance("cdab", 4) == 4);
+
+    std::mt19937_64 rng;
+    std::uniform_int_distribution<int> letter_dist(0, 3);
+    // Lengths span one, two, and three blocks of 64 characters
+    std::uniform_int_distribution<size_t> length_dist(0, 150);
+    auto random_string = [&] {
+        std::string str(length_dist(rng), ' ');
+        for (char& ch : str) {
+            ch = char('a' + letter_dist(rng));
+        }
+        return str;
+    };
+    for (int i = 0; i < 500; i++) {
+        std::string a = random_string();
+        // Mostly near misses, so that the bound is close to the distance
+        std::string b = a;
+        for (int edits = int(rng() % 8); edits > 0 && !b.empty(); edits--) {
+            b[rng() % b.size()] = char('a' + letter_dist(rng));
+            if (rng() % 2 == 0) {
+                b.erase(rng() % b.size(), 1);
+            }
+        }
+        if (i % 4 == 0) {
+            b = random_string();
+        }
+        INFO("a = '" << a << "'\nb = '" << b << "'");
+        int dist = matrix_levenshtein_distance(a, b);
+        pattern p(a, false);
+        for (int max_distance : {0, 1, 2, 3, 5, 8, 70, 200}) {
+            REQUIRE(
+                p.distance(b, max_distance)
+                == std::min(dist, max_distance + 1));
+        }
+    }
+}
+
+template <class Enum>
+void check_fuzzy_match_index(std::string const& query) {
+    using traits = nav::enum_traits<Enum>;
+    constexpr size_t MaxLength = nav::detail::bit_ceil_minus_1(
+        traits::max_name_length * 2);
+    std::string_view truncated = std::string_view(query).substr(0, MaxLength);
+    std::string lowercase(truncated);
+    for (char& ch : lowercase) {
+        ch = nav::detail::to_lower(ch);
+    }
+    INFO("Query: '" << query << "'");
+    REQUIRE(
+        nav::fuzzy_match_enum<Enum>(query)
+        == nav::fuzzy_search(
+            {traits::lowercase_names.data(), traits::size},
+            lowercase,
+            nav::levenshtein_distance<MaxLength>));
+    REQUIRE(
+        nav::fuzzy_match_enum<Enum>(query, false)
+        == nav::fuzzy_search(
+            {traits::names.data(), traits::size},
+            truncated,
+            nav::levenshtein_distance<MaxLength>));
+}
+
+TEST_CASE("Fuzzy match index gives the exhaustive result", "[find_fuzzy]") {
+    std::mt19937_64 rng;
+    std::uniform_int_distribution<int> letter_dist(0, 51);
+    std::uniform_int_distribution<size_t> length_dist(0, 20);
+    auto random_letter = [&] {
+        int letter = letter_dist(rng);
+        return char(letter < 26 ? 'a' + letter : 'A' + letter - 26);
+    };
+
+    for (std::string_view name : nav::enum_names<CommonWords>) {
+        // The name with a few characters changed, and its ends swapped
+        std::string query(name);
+        for (int edits = 0; edits < 3; edits++) {
+            query[rng() % query.size()] = random_letter();
+            check_fuzzy_match_index<CommonWords>(query);
+        }
+        check_fuzzy_match_index<CommonWords>(
+            std::string(name.substr(3)) + std::string(name.substr(0, 3)));
+    }
+    for (int i = 0; i < 1000; i++) {
+        std::string query(length_dist(rng), ' ');
+        for (char& ch : query) {
+            ch = random_letter();
+        }
+        check_fuzzy_match_index<CommonWords>(query);
+    }
+
+    for (std::string query :
+         {"", "a", "A", "aaa", "AaAa", "bb", "abbb", "baab", "aaaaaaaaaaaaa"}) {
+        check_fuzzy_match_index<Repetitive>(query);
+    }
+    for (int i = 0; i < 1000; i++) {
+        std::string query(length_dist(rng), ' ');
+        for (char& ch : query) {
+            ch = "aAbBx"[rng() % 5];
+        }
+        check_fuzzy_match_index<Repetitive>(query);
+    }
+    // Queries longer than MaxLength are truncated
+    check_fuzzy_match_index<Repetitive>(std::string(100, 'a') + "b");
+}
+
+template <class Enum, size_t K>
+void check_fuzzy_match_top(std::string const& query, int max_distance) {
+    using traits = nav::enum_traits<Enum>;
+    constexpr size_t MaxLength = nav::detail::bit_ceil_minus_1(
+        traits::max_name_length * 2);
+    // Every name within max_distance, sorted by distance and then by index
+    std::vector<nav::fuzzy_match> expected;
+    for (size_t i = 0; i < traits::size; i++) {
+        int dist = nav::caseless_levenshtein_distance<MaxLength>(
+            query,
+            traits::names[i]);
+        if (dist <= max_distance) {
+            expected.push_back({i, dist});
+        }
+    }
+    std::stable_sort(
+        expected.begin(),
+        expected.end(),
+        [](nav::fuzzy_match a, nav::fuzzy_match b) {
+            return a.distance < b.distance;
+        });
+    expected.resize(std::min(expected.size(), K));
+
+    auto matches = nav::fuzzy_match_enum_top<Enum, K>(query, max_distance);
+    INFO("Query: '" << query << "', max distance: " << max_distance);
+    REQUIRE(std::vector(matches.begin(), matches.end()) == expected);
+}
+
+TEST_CASE("Fuzzy match the k closest names", "[find_fuzzy]") {
+    auto matches = nav::fuzzy_match_enum_top<CommonWords, 3>("Stat", 1);
+    REQUIRE(matches.size() == 2);
+    REQUIRE(matches[0].distance == 1);
+    REQUIRE(nav::enum_names<CommonWords>[matches[0].index] == "State");
+    REQUIRE(matches[1].distance == 1);
+    REQUIRE(nav::enum_names<CommonWords>[matches[1].index] == "Start");
+
+    REQUIRE(nav::fuzzy_match_enum_top<CommonWords, 3>("Stat", 0).empty());
+    REQUIRE(nav::fuzzy_match_enum_top<CommonWords, 0>("State", 5).empty());
+    REQUIRE(nav::fuzzy_match_enum_top<CommonWords, 3>("State", -1).empty());
+
+    std::mt19937_64 rng;
+    std::uniform_int_distribution<int> letter_dist(0, 25);
+    for (std::string_view name : nav::enum_names<CommonWords>) {
+        std::string query(name);
+        query[rng() % query.size()] = char('a' + letter_dist(rng));
+        query.erase(rng() % query.size(), 1);
+        for (int max_distance : {0, 1, 2, 3, 100}) {
+            check_fuzzy_match_top<CommonWords, 1>(query, max_distance);
+            check_fuzzy_match_top<CommonWords, 5>(query, max_distance);
+        }
+    }
+    for (std::string query : {"", "a", "aaab", "BAAB", "abbaab", "xx"}) {
+        for (int max_distance : {0, 1, 2, 3, 100}) {
+            check_fuzzy_match_top<Repetitive, 1>(query, max_distance);
+            check_fuzzy_match_top<Repetitive, 4>(query, max_distance);
+            check_fuzzy_match_top<Repetitive, 10>(query, max_distance);
+        }
+    }
+}
@@ -0,0 +1,97 @@
+#include <catch2/catch_test_macros.hpp>
+#include <nav/nav_atomic.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+nav_declare_enum(
+    Subsystem,
+    int,
+    Storage = 10,
+    Network = 20,
+    Cache = 30,
+    Scheduler = 40,
+    // Disk is an alias for Storage
+    Disk = Storage);
+
+// Dense enum with more than 64 values, so that the set has several shards
+nav_declare_enum(
+    Feature,
+    unsigned char,
+    F0, F1, F2, F3, F4, F5, F6, F7, F8, F9,
+    F10, F11, F12, F13, F14, F15, F16, F17, F18, F19,
+    F20, F21, F22, F23, F24, F25, F26, F27, F28, F29,
+    F30, F31, F32, F33, F34, F35, F36, F37, F38, F39,
+    F40, F41, F42, F43, F44, F45, F46, F47, F48, F49,
+    F50, F51, F52, F53, F54, F55, F56, F57, F58, F59,
+    F60, F61, F62, F63, F64, F65, F66, F67, F68, F69,
+    F70, F71, F72, F73, F74, F75, F76, F77, F78, F79,
+    F80, F81, F82, F83, F84, F85, F86, F87, F88, F89,
+    F90, F91, F92, F93, F94, F95, F96, F97, F98, F99,
+    F100, F101, F102, F103, F104, F105, F106, F107, F108, F109,
+    F110, F111, F112, F113, F114, F115, F116, F117, F118, F119,
+    F120, F121, F122, F123, F124, F125, F126, F127, F128, F129);
+
+TEST_CASE("atomic_enum_set inserts, erases, and snapshots", "[atomic]") {
+    nav::atomic_enum_set<Subsystem> degraded;
+    REQUIRE(degraded.snapshot().empty());
+    REQUIRE(degraded.insert(Subsystem::Cache));
+    REQUIRE(degraded.insert(Subsystem::Disk));
+    REQUIRE_FALSE(degraded.insert(Subsystem::Storage));
+    REQUIRE_FALSE(degraded.insert(Subsystem(15)));
+    REQUIRE(degraded.contains(Subsystem::Storage));
+    REQUIRE_FALSE(degraded.contains(Subsystem::Network));
+
+    std::string names;
+    for (auto [name, value] : degraded.snapshot().entries()) {
+        REQUIRE(nav::name_of(value) == name);
+        names += std::string(name) + ",";
+    }
+    REQUIRE(names == "Storage,Cache,");
+
+    REQUIRE(degraded.erase(Subsystem::Cache));
+    REQUIRE_FALSE(degraded.erase(Subsystem::Cache));
+    REQUIRE(degraded.snapshot() == nav::enum_set {Subsystem::Storage});
+    degraded.clear();
+    REQUIRE(degraded.snapshot().empty());
+}
+
+TEST_CASE("atomic_enum_set shards are on separate cache lines", "[atomic]") {
+    using set = nav::atomic_enum_set<Feature>;
+    REQUIRE(set::num_words == 3);
+    REQUIRE(sizeof(set) == 3 * nav::detail::cache_line_size);
+    REQUIRE(alignof(set) == nav::detail::cache_line_size);
+    REQUIRE(sizeof(nav::atomic_enum_set<Subsystem>) == 64);
+}
+
+TEST_CASE("atomic_enum_set is updated by many threads", "[atomic]") {
+    // Each thread owns the features whose index is its thread id modulo
+    // num_threads. It repeatedly inserts and erases them, and finishes with
+    // the odd ones inserted
+    constexpr size_t num_threads = 4;
+    nav::atomic_enum_set<Feature> features(
+        nav::enum_set {Feature::F0, Feature::F129});
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; t++) {
+        threads.emplace_back([&features, t] {
+            for (int round = 0; round < 1000; round++) {
+                size_t size = nav::num_states<Feature>;
+                for (size_t i = t; i < size; i += num_threads) {
+                    if (i % 2 == 1 || round % 2 == 0) {
+                        features.insert(Feature(i));
+                    } else {
+                        features.erase(Feature(i));
+                    }
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto snapshot = features.snapshot();
+    REQUIRE(snapshot.size() == nav::num_states<Feature> / 2);
+    for (Feature feature : snapshot) {
+        REQUIRE(size_t(feature) % 2 == 1);
+    }
+}
@@ -0,0 +1,167 @@
+#include <catch2/catch_test_macros.hpp>
+#include <nav/nav_batch.hpp>
+#include <string>
+#include <vector>
+
+nav_declare_enum(
+    HttpMethod,
+    int,
+    Get,
+    Head,
+    Post,
+    Put,
+    Delete,
+    Connect,
+    Options,
+    Trace,
+    Patch,
+    PropFind,
+    PropPatch,
+    MkCol,
+    Copy,
+    Move,
+    Lock,
+    Unlock,
+    VersionControl,
+    BaselineControl,
+    MkWorkspace,
+    UpdateRedirectRef,
+    ExtremelyLongMethodNameThatSpansSeveralBlocks);
+
+// These names have the same size, and the same first and last 8 bytes
+nav_declare_enum(
+    SameFingerprint,
+    int,
+    LongPrefix_A_LongSuffix,
+    LongPrefix_B_LongSuffix,
+    LongPrefix_C_LongSuffix);
+
+nav_declare_enum(Suit, char, Clubs = 'c', Diamonds = 'd', Hearts, Spades);
+
+template <class Enum>
+void check_parse_names(std::vector<std::string_view> const& names) {
+    using traits = nav::enum_traits<Enum>;
+    std::vector<Enum> values(names.size());
+    std::vector<uint64_t> valid(nav::bitmap_words(names.size()), ~uint64_t(0));
+
+    size_t num_found = nav::parse_names<Enum>(
+        nav::view {names.data(), names.size()},
+        values.data(),
+        valid.data());
+
+    size_t expected_found = 0;
+    for (size_t i = 0; i < names.size(); i++) {
+        INFO("Name: " << names[i]);
+        auto expected = traits::get_value(names[i]);
+        bool is_valid = (valid[i / 64] >> (i % 64)) & 1;
+        REQUIRE(is_valid == expected.has_value());
+        REQUIRE(values[i] == expected.value_or(Enum()));
+        expected_found += expected.has_value();
+    }
+    REQUIRE(num_found == expected_found);
+}
+
+TEST_CASE("parse_names matches get_value", "[batch]") {
+    std::vector<std::string_view> names;
+    for (int repeat = 0; repeat < 10; repeat++) {
+        for (auto name : nav::enum_names<HttpMethod>) {
+            names.push_back(name);
+        }
+    }
+    // Misses with the same length as a name, the prefix of a name, and a name
+    // with an extra character
+    names.push_back("Gex");
+    names.push_back("Delet");
+    names.push_back("Patchy");
+    names.push_back("");
+    names.push_back("ExtremelyLongMethodNameThatSpansSeveralBlockz");
+    names.push_back("extremelyLongMethodNameThatSpansSeveralBlocks");
+    // Misses which only differ from a name in the middle
+    names.push_back("UpdateRedirecTRef");
+    names.push_back("ExtremelyLongMethodNameThatSpanzSeveralBlocks");
+
+    check_parse_names<HttpMethod>(names);
+    check_parse_names<Suit>({"Clubs", "Diamonds", "Hearts", "Spades", "Joker"});
+    check_parse_names<Suit>({});
+
+    REQUIRE(nav::detail::batch_lookup<HttpMethod>::use_table);
+    REQUIRE_FALSE(nav::detail::batch_lookup<SameFingerprint>::use_table);
+    check_parse_names<SameFingerprint>(
+        {"LongPrefix_A_LongSuffix",
+         "LongPrefix_C_LongSuffix",
+         "LongPrefix_D_LongSuffix"});
+}
+
+TEST_CASE("parse_names reads packed names", "[batch]") {
+    std::string data = "PutNopeLockHeartsMove";
+    std::vector<unsigned> offsets {0, 3, 7, 11, 17, 21};
+
+    HttpMethod values[5];
+    uint64_t valid[1];
+    size_t num_found = nav::parse_names<HttpMethod>(
+        data.data(),
+        nav::view {offsets.data(), offsets.size()},
+        values,
+        valid);
+
+    REQUIRE(num_found == 3);
+    REQUIRE(valid[0] == 0b10101);
+    REQUIRE(values[0] == HttpMethod::Put);
+    REQUIRE(values[1] == HttpMethod());
+    REQUIRE(values[2] == HttpMethod::Lock);
+    REQUIRE(values[3] == HttpMethod());
+    REQUIRE(values[4] == HttpMethod::Move);
+}
+
+template <class Enum>
+std::string join_names(
+    std::vector<Enum> const& values,
+    std::string_view separator,
+    std::string_view fallback) {
+    nav::view<Enum> view {values.data(), values.size()};
+    std::string result(nav::names_size(view, separator, fallback), '?');
+    char* end = nav::write_names(
+        view,
+        result.data(),
+        result.size(),
+        separator,
+        fallback);
+    REQUIRE(end == result.data() + result.size());
+    return result;
+}
+
+TEST_CASE("write_names joins names", "[batch]") {
+    std::vector<HttpMethod> methods {
+        HttpMethod::Get,
+        HttpMethod::ExtremelyLongMethodNameThatSpansSeveralBlocks,
+        HttpMethod(-1),
+        HttpMethod::Put};
+
+    REQUIRE(
+        join_names(methods, ", ", "?")
+        == "Get, ExtremelyLongMethodNameThatSpansSeveralBlocks, ?, Put");
+    REQUIRE(
+        join_names(methods, "", "")
+        == "GetExtremelyLongMethodNameThatSpansSeveralBlocksPut");
+    REQUIRE(join_names(std::vector {HttpMethod::Lock}, ",", "?") == "Lock");
+    REQUIRE(join_names(std::vector<HttpMethod> {}, ",", "?") == "");
+
+    // Suit is sparse, so names are found through a binary search
+    REQUIRE(
+        join_names(
+            std::vector {Suit::Spades, Suit('x'), Suit::Clubs, Suit::Hearts},
+            "|",
+            "-")
+        == "Spades|-|Clubs|Hearts");
+
+    // The result is the same as joining the result of name_of on each value
+    std::vector<HttpMethod> all_methods;
+    std::string expected;
+    for (auto value : nav::enum_values<HttpMethod>) {
+        all_methods.push_back(value);
+        expected += nav::name_of(value).value();
+        expected += '\n';
+    }
+    expected.pop_back();
+    REQUIRE(join_names(all_methods, "\n", "") == expected);
+}
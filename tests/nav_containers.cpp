@@ -0,0 +1,167 @@
+#include <catch2/catch_test_macros.hpp>
+#include <nav/nav_containers.hpp>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Sparse enum with an alias
+nav_declare_enum(
+    Signal,
+    int,
+    Hangup = 1,
+    Interrupt = 2,
+    Kill = 9,
+    Terminate = 15,
+    Stop = 19,
+    // Abort is an alias for Interrupt
+    Abort = Interrupt,
+    RealtimeMin = 34,
+    RealtimeMax = 64,
+    User = 0x10000);
+
+// Dense enum with more than 64 values, so that sets span several words
+nav_declare_enum(
+    Key,
+    unsigned char,
+    K0, K1, K2, K3, K4, K5, K6, K7, K8, K9,
+    K10, K11, K12, K13, K14, K15, K16, K17, K18, K19,
+    K20, K21, K22, K23, K24, K25, K26, K27, K28, K29,
+    K30, K31, K32, K33, K34, K35, K36, K37, K38, K39,
+    K40, K41, K42, K43, K44, K45, K46, K47, K48, K49,
+    K50, K51, K52, K53, K54, K55, K56, K57, K58, K59,
+    K60, K61, K62, K63, K64, K65, K66, K67, K68, K69);
+
+TEST_CASE("ordinal_of gives the index of the first name", "[containers]") {
+    for (size_t i = 0; i < nav::num_states<Key>; i++) {
+        REQUIRE(nav::ordinal_of(nav::enum_values<Key>[i]) == i);
+    }
+    REQUIRE(nav::ordinal_of(Key(70)) == nav::num_states<Key>);
+
+    REQUIRE(nav::ordinal_of(Signal::Kill) == 2);
+    REQUIRE(nav::ordinal_of(Signal::Abort) == 1);
+    REQUIRE(nav::ordinal_of(Signal::User) == 8);
+    REQUIRE(nav::ordinal_of(Signal(3)) == nav::num_states<Signal>);
+    static_assert(nav::ordinal_of(Signal::Stop) == 4);
+}
+
+TEST_CASE("enum_set inserts, erases, and iterates", "[containers]") {
+    auto set = nav::enum_set<Signal> {Signal::Stop, Signal::Hangup};
+    REQUIRE(set.size() == 2);
+    REQUIRE(set.contains(Signal::Hangup));
+    REQUIRE_FALSE(set.contains(Signal::Kill));
+
+    REQUIRE(set.insert(Signal::Abort));
+    REQUIRE_FALSE(set.insert(Signal::Interrupt));
+    REQUIRE_FALSE(set.insert(Signal(3)));
+    REQUIRE(set.contains(Signal::Interrupt));
+    REQUIRE_FALSE(set.contains(Signal(3)));
+
+    // Values come out in declaration order
+    auto values = std::vector<Signal>(set.begin(), set.end());
+    REQUIRE(
+        values
+        == std::vector {Signal::Hangup, Signal::Interrupt, Signal::Stop});
+
+    REQUIRE(set.erase(Signal::Hangup));
+    REQUIRE_FALSE(set.erase(Signal::Hangup));
+    REQUIRE(set.size() == 2);
+    set.clear();
+    REQUIRE(set.empty());
+    REQUIRE(set.begin() == set.end());
+}
+
+TEST_CASE("enum_set spans several words", "[containers]") {
+    nav::enum_set<Key> evens;
+    nav::enum_set<Key> high;
+    for (Key key : nav::enum_values<Key>) {
+        if (size_t(key) % 2 == 0) {
+            evens.insert(key);
+        }
+        if (size_t(key) >= 60) {
+            high.insert(key);
+        }
+    }
+    REQUIRE(evens.num_words == 2);
+    REQUIRE(evens.size() == 35);
+    REQUIRE((evens & high).size() == 5);
+    REQUIRE((evens | high).size() == 40);
+    REQUIRE((high - evens).size() == 5);
+    REQUIRE((evens - evens).empty());
+    REQUIRE(nav::enum_set<Key>::from_bits(high.bits()) == high);
+
+    size_t expected = 60;
+    for (Key key : high) {
+        REQUIRE(size_t(key) == expected++);
+    }
+    REQUIRE(expected == 70);
+    static_assert(std::is_trivially_copyable_v<nav::enum_set<Key>>);
+}
+
+TEST_CASE("enum_set::from_bits ignores bits without a value", "[containers]") {
+    // Every bit set, including those past the last ordinal, and the ordinal of
+    // the alias Abort
+    auto signals = nav::enum_set<Signal>::from_bits({~uint64_t(0)});
+    REQUIRE(signals.size() == 8);
+    REQUIRE(std::vector<Signal>(signals.begin(), signals.end()).size() == 8);
+    REQUIRE(signals.contains(Signal::Abort));
+    REQUIRE_FALSE(signals.contains(Signal(3)));
+
+    auto keys = nav::enum_set<Key>::from_bits({~uint64_t(0), ~uint64_t(0)});
+    REQUIRE(keys.size() == 70);
+    size_t count = 0;
+    for (Key key : keys) {
+        REQUIRE(size_t(key) == count++);
+    }
+    REQUIRE(count == 70);
+    static_assert(nav::enum_set<Key>::from_bits({0, 1 << 6}).empty());
+}
+
+TEST_CASE("enum_map is indexed by ordinal", "[containers]") {
+    nav::enum_map<Signal, int> counts;
+    REQUIRE(counts.size() == 8);
+    counts[Signal::Kill] += 3;
+    counts[Signal::Abort] += 1;
+    counts[Signal::Interrupt] += 1;
+    REQUIRE(counts[Signal::Kill] == 3);
+    REQUIRE(counts[Signal::Interrupt] == 2);
+    REQUIRE(counts.find(Signal(3)) == nullptr);
+    REQUIRE(*counts.find(Signal::Abort) == 2);
+    REQUIRE(counts.contains(Signal::User));
+    REQUIRE_FALSE(counts.contains(Signal(3)));
+
+    // Each value is visited once, with the first name declared for it
+    std::string joined;
+    for (auto [value, name, count] : counts) {
+        REQUIRE(nav::name_of(value) == name);
+        joined += std::string(name) + "=" + std::to_string(count) + ",";
+        count = 10;
+    }
+    REQUIRE(
+        joined
+        == "Hangup=0,Interrupt=2,Kill=3,Terminate=0,Stop=0,RealtimeMin=0,"
+           "RealtimeMax=0,User=0,");
+    REQUIRE(counts[Signal::User] == 10);
+
+    auto const& const_counts = counts;
+    for (auto entry : const_counts) {
+        REQUIRE(entry.mapped == 10);
+    }
+
+    auto names = nav::enum_map<Key, std::string>("unset");
+    names[Key::K69] = "last";
+    REQUIRE(names[Key::K0] == "unset");
+    REQUIRE(names[Key::K69] == "last");
+}
+
+TEST_CASE("enum_map and enum_set work at compile time", "[containers]") {
+    constexpr auto map = [] {
+        nav::enum_map<Signal, int> result;
+        for (auto [value, name, element] : result) {
+            element = int(name.size()) + int(value);
+        }
+        return result;
+    }();
+    static_assert(map[Signal::Stop] == 4 + 19);
+    constexpr auto set = nav::enum_set<Signal> {Signal::User, Signal::Kill};
+    static_assert(set.size() == 2 && *set.begin() == Signal::Kill);
+}
@@ -1,6 +1,7 @@
 #include <catch2/catch_test_macros.hpp>
 #include <fmt/core.h>
 #include <nav/nav_core.hpp>
+#include <string>
 #include <type_traits>
 
 nav_declare_enum(
@@ -17,6 +18,63 @@ nav_declare_enum(
     // We're representing violet as Red + Blue
     Violet = Red + Blue);
 
+// Dense enum with aliased values
+nav_declare_enum(
+    Direction,
+    short,
+    North = -1,
+    East,
+    South,
+    West,
+    // Up is an alias for North
+    Up = North,
+    Down = South);
+
+// Flag enum with a name for no flags, a name for a combination of flags, and
+// bits without a name (0x08 through 0x40)
+nav_declare_flag_enum(
+    Permissions,
+    unsigned char,
+    None = 0,
+    Read = 1,
+    Write = 2,
+    Execute = 4,
+    ReadWrite = Read | Write,
+    Admin = 0x80);
+
+// A flag enum in a namespace that declares an operator| of its own, which hides
+// the operators in the global namespace
+namespace flag_scope {
+enum class Access : unsigned;
+struct Mask {
+    unsigned bits;
+};
+constexpr Mask operator|(Mask a, Mask b) noexcept {
+    return {a.bits | b.bits};
+}
+nav_declare_flag_operators();
+} // namespace flag_scope
+
+nav_declare_flag_enum(flag_scope::Access, unsigned, Read = 1, Write = 2);
+
+namespace flag_scope {
+constexpr Access read_write = Access::Read | Access::Write;
+constexpr Access write_only = read_write & ~Access::Read;
+constexpr Permissions read_execute = Permissions::Read | Permissions::Execute;
+constexpr Mask mask = Mask {1} | Mask {4};
+} // namespace flag_scope
+
+// Values that depend on values assigned implicitly, written without spaces
+// around '='
+nav_declare_enum(
+    Steps,
+    signed char,
+    First,
+    Second,
+    Double=Second * 2,
+    Next,
+    Max=127);
+
 TEST_CASE("Count values", "[core]") {
     REQUIRE(nav::is_nav_enum<RainbowColors>);
     REQUIRE(nav::num_states<RainbowColors> == 7);
@@ -69,6 +127,24 @@ TEST_CASE("Check names", "[core]") {
     REQUIRE(names[6] == "Violet");
 }
 
+TEST_CASE("Implicit values", "[core]") {
+    using base = std::underlying_type_t<Steps>;
+    REQUIRE(nav::num_states<Steps> == 5);
+    REQUIRE(nav::enum_values<Steps>[0] == Steps::First);
+    REQUIRE(nav::enum_values<Steps>[1] == Steps::Second);
+    REQUIRE(nav::enum_values<Steps>[2] == Steps::Double);
+    REQUIRE(nav::enum_values<Steps>[3] == Steps::Next);
+    REQUIRE(nav::enum_values<Steps>[4] == Steps::Max);
+    REQUIRE(base(Steps::Double) == 2);
+    REQUIRE(base(Steps::Next) == 3);
+
+    auto names = nav::enum_names<Steps>;
+    REQUIRE(names.size() == 5);
+    REQUIRE(names[0] == "First");
+    REQUIRE(names[2] == "Double");
+    REQUIRE(names[4] == "Max");
+}
+
 TEST_CASE("Iterate over values", "[core]") {
     auto names = nav::enum_names<RainbowColors>;
     auto values = nav::enum_values<RainbowColors>;
@@ -119,6 +195,49 @@ TEST_CASE("Iterate over names", "[core]") {
     }
 }
 
+TEST_CASE("Iterate over entries", "[core][entries]") {
+    auto names = nav::enum_names<RainbowColors>;
+    auto values = nav::enum_values<RainbowColors>;
+    auto entries = nav::enum_entries<RainbowColors>;
+
+    REQUIRE(entries.size() == 7);
+    REQUIRE(entries.end() - entries.begin() == 7);
+    size_t index = 0;
+    for (auto [name, value] : entries) {
+        REQUIRE(name == names[index]);
+        REQUIRE(value == values[index]);
+        index++;
+    }
+    REQUIRE(index == 7);
+
+    // Entries are random access, and can be walked in reverse
+    auto it = entries.end();
+    REQUIRE((*--it).name == "Violet");
+    REQUIRE(it[-6].name == "Red");
+    REQUIRE((*(entries.begin() + 3)).value == RainbowColors::Green);
+    REQUIRE(entries[4].name == "Blue");
+    REQUIRE(entries.begin() < it);
+
+    static_assert(nav::enum_entries<Direction>[1].name == "East");
+    static_assert(nav::enum_entries<Direction>[4].value == Direction::North);
+
+    enum class UnknownEnum { A, B, C };
+    REQUIRE(
+        nav::enum_entries<UnknownEnum>.begin()
+        == nav::enum_entries<UnknownEnum>.end());
+}
+
+TEST_CASE("Name offsets use the smallest type that fits", "[core]") {
+    using block_type = nav::enum_name_list<RainbowColors>::block_type;
+    REQUIRE(std::is_same_v<block_type::offset_type, uint8_t>);
+    REQUIRE(sizeof(block_type) == block_type::block_size() + 8);
+
+    REQUIRE(std::is_same_v<nav::string_block<1, 255>::offset_type, uint8_t>);
+    REQUIRE(std::is_same_v<nav::string_block<1, 256>::offset_type, uint16_t>);
+    REQUIRE(
+        std::is_same_v<nav::string_block<1, 65536>::offset_type, uint32_t>);
+}
+
 TEST_CASE(
     "Check that nav behaves sensibly for undeclared enums",
     "[core][empty]") {
@@ -142,6 +261,138 @@ TEST_CASE(
         == nav::enum_values<UnknownEnum>.end());
 }
 
+TEST_CASE("Look up names from values", "[core][name_of]") {
+    auto names = nav::enum_names<RainbowColors>;
+    auto values = nav::enum_values<RainbowColors>;
+
+    for (size_t i = 0; i < nav::num_states<RainbowColors>; i++) {
+        std::string_view name;
+        REQUIRE(nav::name_of(values[i], name));
+        REQUIRE(name == names[i]);
+        REQUIRE(nav::name_of(values[i]) == names[i]);
+    }
+    REQUIRE(nav::name_of(RainbowColors::Green, true) == "green");
+    REQUIRE(nav::name_of(RainbowColors(1)) == std::nullopt);
+
+    std::string_view name = "unchanged";
+    REQUIRE_FALSE(nav::name_of(RainbowColors(-1), name));
+    REQUIRE(name == "unchanged");
+}
+
+TEST_CASE("Look up names from values in a dense enum", "[core][name_of]") {
+    // Aliases get the name that was declared first
+    REQUIRE(nav::name_of(Direction::North) == "North");
+    REQUIRE(nav::name_of(Direction::Up) == "North");
+    REQUIRE(nav::name_of(Direction::East) == "East");
+    REQUIRE(nav::name_of(Direction::Down) == "South");
+    REQUIRE(nav::name_of(Direction::West, true) == "west");
+    REQUIRE(nav::name_of(Direction(-2)) == std::nullopt);
+    REQUIRE(nav::name_of(Direction(3)) == std::nullopt);
+
+    static_assert(nav::name_of(Direction::South) == "South");
+}
+
+TEST_CASE("Look up values from names", "[core][value_of]") {
+    auto names = nav::enum_names<RainbowColors>;
+    auto values = nav::enum_values<RainbowColors>;
+
+    for (size_t i = 0; i < nav::num_states<RainbowColors>; i++) {
+        RainbowColors value {};
+        REQUIRE(nav::value_of(names[i], value));
+        REQUIRE(value == values[i]);
+        REQUIRE(nav::value_of<RainbowColors>(names[i]) == values[i]);
+    }
+    REQUIRE(nav::value_of<RainbowColors>("red") == std::nullopt);
+    REQUIRE(nav::value_of<RainbowColors>("Re") == std::nullopt);
+    REQUIRE(nav::value_of<RainbowColors>("") == std::nullopt);
+
+    RainbowColors value = RainbowColors::Blue;
+    REQUIRE_FALSE(nav::value_of("Purple", value));
+    REQUIRE(value == RainbowColors::Blue);
+
+    REQUIRE(nav::value_of<Direction>("Up") == Direction::North);
+    static_assert(nav::value_of<Direction>("Down") == Direction::South);
+}
+
+TEST_CASE("Look up values from names, ignoring case", "[core][value_of]") {
+    REQUIRE(nav::value_of<RainbowColors>("red", true) == RainbowColors::Red);
+    REQUIRE(nav::value_of<RainbowColors>("RED", true) == RainbowColors::Red);
+    REQUIRE(
+        nav::value_of<RainbowColors>("iNdIgO", true) == RainbowColors::Indigo);
+    REQUIRE(nav::value_of<RainbowColors>("indigo!", true) == std::nullopt);
+    REQUIRE(nav::value_of<Direction>("down", true) == Direction::South);
+}
+
+// Joins the names passed by for_each_flag_name, or returns "<none>" if it fails
+template <class Enum>
+std::string flag_names(Enum value) {
+    std::string result;
+    bool found = nav::for_each_flag_name(value, [&](std::string_view name) {
+        result += result.empty() ? "" : "|";
+        result += name;
+    });
+    return found ? result : "<none>";
+}
+
+TEST_CASE("Flag enums", "[core][flags]") {
+    using P = Permissions;
+    STATIC_REQUIRE(nav::is_flag_enum<Permissions>);
+    STATIC_REQUIRE_FALSE(nav::is_flag_enum<Direction>);
+
+    STATIC_REQUIRE((P::Read | P::Write) == P::ReadWrite);
+    STATIC_REQUIRE((P::ReadWrite & P::Write) == P::Write);
+    STATIC_REQUIRE((P::ReadWrite ^ P::Read) == P::Write);
+    STATIC_REQUIRE((~P::Read & P::ReadWrite) == P::Write);
+    P value = P::Read;
+    value |= P::Execute;
+    REQUIRE(value == P(5));
+    value &= P::Execute;
+    REQUIRE(value == P::Execute);
+    value ^= P::Admin;
+    REQUIRE(value == P(0x84));
+
+    // Values with a name of their own use that name
+    REQUIRE(flag_names(P::None) == "None");
+    REQUIRE(flag_names(P::ReadWrite) == "ReadWrite");
+    // Other values are named one flag at a time, in order of bit position
+    REQUIRE(flag_names(P::Admin | P::Read) == "Read|Admin");
+    REQUIRE(flag_names(P::ReadWrite | P::Execute) == "Read|Write|Execute");
+    // Unless some bits have no name
+    REQUIRE(flag_names(P(0x08)) == "<none>");
+    REQUIRE(flag_names(P::Read | P(0x40)) == "<none>");
+    REQUIRE(flag_names(Direction::North) == "North");
+
+    REQUIRE(nav::value_of<P>("Read|Execute") == (P::Read | P::Execute));
+    REQUIRE(nav::value_of<P>("Execute|Read|Read") == (P::Read | P::Execute));
+    REQUIRE(nav::value_of<P>("ReadWrite|Admin") == (P::ReadWrite | P::Admin));
+    REQUIRE(nav::value_of<P>("read|WRITE", true) == P::ReadWrite);
+    REQUIRE(nav::value_of<P>("None") == P::None);
+    for (auto text : {"", "|", "Read|", "|Read", "Read||Write", "Read|Nope"}) {
+        INFO("Text: " << text);
+        REQUIRE(nav::value_of<P>(text) == std::nullopt);
+    }
+    STATIC_REQUIRE(nav::value_of<P>("Write|Admin") == (P::Write | P::Admin));
+    // Names of other enums can't be combined
+    REQUIRE(nav::value_of<Direction>("North|South") == std::nullopt);
+}
+
+TEST_CASE("Flag operators are found from inside namespaces", "[core][flags]") {
+    using flag_scope::Access;
+    STATIC_REQUIRE(flag_scope::read_write == Access(3));
+    STATIC_REQUIRE(flag_scope::write_only == Access::Write);
+    STATIC_REQUIRE(flag_scope::read_execute == Permissions(5));
+    STATIC_REQUIRE(flag_scope::mask.bits == 5);
+    REQUIRE(nav::value_of<Access>("Read|Write") == flag_scope::read_write);
+}
+
+TEST_CASE("Lookups on undeclared enums fail", "[core][empty]") {
+    enum class UnknownEnum { A, B, C };
+
+    REQUIRE(nav::name_of(UnknownEnum::A) == std::nullopt);
+    REQUIRE(nav::value_of<UnknownEnum>("A") == std::nullopt);
+    REQUIRE(nav::value_of<UnknownEnum>("A", true) == std::nullopt);
+}
+
 #if NAV_ADD_NULL_TERMINATORS
 TEST_CASE("Ensure names end with null terminator", "[core]") {
     auto names = nav::enum_names<RainbowColors>;
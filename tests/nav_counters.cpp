@@ -0,0 +1,112 @@
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <nav/nav_counters.hpp>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+nav_declare_enum(
+    ErrorCode,
+    int,
+    Ok = 0,
+    NotFound = 404,
+    Timeout = 408,
+    Internal = 500,
+    // ServerError is an alias for Internal
+    ServerError = Internal);
+
+TEST_CASE("enum_counters counts from many threads", "[counters]") {
+    // Fewer shards than threads, so that some shards are shared
+    constexpr int num_threads = 6;
+    nav::enum_counters<ErrorCode> counters(3);
+    REQUIRE(counters.num_shards() == 4);
+    std::atomic<int> unnamed_added {0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&counters, &unnamed_added] {
+            for (int i = 0; i < 10000; i++) {
+                counters.add(ErrorCode::Timeout);
+                counters.add(i % 2 == 0 ? ErrorCode::Internal
+                                        : ErrorCode::ServerError);
+                unnamed_added += counters.add(ErrorCode(403));
+            }
+            counters.add(ErrorCode::NotFound, 5);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    REQUIRE(unnamed_added == 0);
+    auto counts = counters.snapshot();
+    REQUIRE(counts[ErrorCode::Ok] == 0);
+    REQUIRE(counts[ErrorCode::NotFound] == 5 * num_threads);
+    REQUIRE(counts[ErrorCode::Timeout] == 10000 * num_threads);
+    REQUIRE(counts[ErrorCode::Internal] == 10000 * num_threads);
+
+    counters.reset();
+    REQUIRE(counters.snapshot()[ErrorCode::Timeout] == 0);
+}
+
+TEST_CASE("Thread indices are reused once a thread exits", "[counters]") {
+    size_t main_index = nav::detail::this_thread_index();
+    auto index_of_new_thread = [] {
+        size_t index = 0;
+        std::thread([&index] {
+            index = nav::detail::this_thread_index();
+        }).join();
+        return index;
+    };
+    size_t first = index_of_new_thread();
+    REQUIRE(first != main_index);
+    REQUIRE(index_of_new_thread() == first);
+
+    // Threads running at the same time have different indices
+    std::atomic<int> started {0};
+    std::vector<size_t> indices(4);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < indices.size(); t++) {
+        threads.emplace_back([&, t] {
+            indices[t] = nav::detail::this_thread_index();
+            started++;
+            while (started < int(indices.size())) {
+                std::this_thread::yield();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (size_t a = 0; a < indices.size(); a++) {
+        REQUIRE(indices[a] != main_index);
+        REQUIRE(indices[a] <= indices.size());
+        for (size_t b = a + 1; b < indices.size(); b++) {
+            REQUIRE(indices[a] != indices[b]);
+        }
+    }
+}
+
+TEST_CASE("enum_counters writes name value lines", "[counters]") {
+    nav::enum_counters<ErrorCode> counters;
+    counters.add(ErrorCode::NotFound, 3);
+    counters.add(ErrorCode::Internal, -12);
+
+    char buffer[nav::enum_counters<ErrorCode>::max_output_size] {};
+    auto result = counters.write_to(buffer, buffer + sizeof(buffer));
+    REQUIRE(result.ec == std::errc {});
+    REQUIRE(
+        std::string_view(buffer, size_t(result.ptr - buffer))
+        == "Ok 0\nNotFound 3\nTimeout 0\nInternal -12\n");
+
+    // Output that doesn't fit is an error
+    for (size_t size : {0, 4, 10, 38}) {
+        auto partial = counters.write_to(buffer, buffer + size);
+        REQUIRE(partial.ec == std::errc::value_too_large);
+    }
+
+    // The maximum size fits the longest possible counts
+    nav::enum_map<ErrorCode, int64_t> extremes(INT64_MIN);
+    result = nav::write_counts(buffer, buffer + sizeof(buffer), extremes);
+    REQUIRE(result.ec == std::errc {});
+    REQUIRE(result.ptr == buffer + sizeof(buffer));
+}
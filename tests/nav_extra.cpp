@@ -8,6 +8,18 @@ enum class Color;
 
 nav_declare_enum(test_nav::Color, int, Red, Green, Blue);
 
+namespace test_nav {
+enum class Access : unsigned;
+}
+
+nav_declare_flag_enum(
+    test_nav::Access,
+    unsigned,
+    Read = 1,
+    Write = 2,
+    Execute = 4,
+    ReadWrite = Read | Write);
+
 TEST_CASE("Testing nav_libfmt", "[extra][fmt]") {
     using test_nav::Color;
 
@@ -76,3 +88,34 @@ TEST_CASE("Testing nav_libfmt", "[extra][fmt]") {
     REQUIRE(fmt::format("{:F^29}", Color(-1))    == "     test_nav::Color(-1)     ");
     // clang-format on
 }
+
+TEST_CASE("Testing nav_libfmt with flags", "[extra][fmt][flags]") {
+    using test_nav::Access;
+
+    // clang-format off
+    REQUIRE(fmt::format("{}", Access::Read)                   == "Read");
+    REQUIRE(fmt::format("{}", Access::Read | Access::Execute) == "Read|Execute");
+    REQUIRE(fmt::format("{}", Access::ReadWrite)              == "ReadWrite");
+    REQUIRE(fmt::format("{}", Access(8))                      == "Access(8)");
+
+    REQUIRE(fmt::format("{:Q}", Access::Read | Access::Execute)
+            == "Access::Read|Access::Execute");
+    REQUIRE(fmt::format("{:F}", Access::Write | Access::Execute)
+            == "test_nav::Access::Write|test_nav::Access::Execute");
+    REQUIRE(fmt::format("{:>14}", Access::Read | Access::Execute)
+            == "  Read|Execute");
+    REQUIRE(fmt::format("{:Q}", Access::ReadWrite)  == "Access::ReadWrite");
+    REQUIRE(fmt::format("{:F}", Access(9))          == "test_nav::Access(9)");
+    // clang-format on
+}
+
+TEST_CASE("Qualified names are built at compile time", "[extra][fmt]") {
+    using qualified = nav::detail::prefixed_names<test_nav::Color, false>;
+    using full = nav::detail::prefixed_names<test_nav::Color, true>;
+    static_assert(qualified::block[0] == "Color::Red");
+    static_assert(qualified::block[2] == "Color::Blue");
+    static_assert(full::block[1] == "test_nav::Color::Green");
+#if NAV_ADD_NULL_TERMINATORS
+    REQUIRE(*(full::block[1].data() + full::block[1].size()) == '\0');
+#endif
+}
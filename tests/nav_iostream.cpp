@@ -2,7 +2,7 @@
 #include <nav/nav_iostream.hpp>
 #include <sstream>
 
-template <nav::nav_enum Enum>
+template <class Enum>
 std::string make_string(Enum value) {
     using nav::operator<<;
     std::stringstream ss;
@@ -16,6 +16,18 @@ enum class Color;
 
 nav_declare_enum(test_nav::Color, int, Red, Green, Blue);
 
+namespace test_nav {
+enum class Access : unsigned;
+}
+
+nav_declare_flag_enum(
+    test_nav::Access,
+    unsigned,
+    Read = 1,
+    Write = 2,
+    Execute = 4,
+    ReadWrite = Read | Write);
+
 TEST_CASE("Testing nav_iostream", "[extra][stream]") {
     using test_nav::Color;
 
@@ -26,3 +38,14 @@ TEST_CASE("Testing nav_iostream", "[extra][stream]") {
     REQUIRE(make_string(Color(-1))    == "Color(-1)");
     // clang-format on
 }
+
+TEST_CASE("Testing nav_iostream with flags", "[extra][stream][flags]") {
+    using test_nav::Access;
+
+    // clang-format off
+    REQUIRE(make_string(Access::Read)                   == "Access::Read");
+    REQUIRE(make_string(Access::ReadWrite)              == "Access::ReadWrite");
+    REQUIRE(make_string(Access::Read | Access::Execute) == "Access::Read|Access::Execute");
+    REQUIRE(make_string(Access(8))                      == "Access(8)");
+    // clang-format on
+}
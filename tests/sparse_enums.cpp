@@ -1,4 +1,5 @@
-#include <nav/nav_core.hpp>
+#include <algorithm>
+#include <nav/core.hpp>
 #include <fmt/core.h>
 #include <iostream>
 
@@ -135,6 +136,75 @@ std::ostream& operator<<(std::ostream& os, std::optional<T> const& value) {
     return os;
 }
 
+// Names which only differ in case. Lookups which ignore case should find the
+// name which was declared first
+nav_declare_enum(
+    CaseCollision,
+    int,
+    Value,
+    VALUE,
+    value,
+    OtherValue,
+    LongerNameSpanningBlocks,
+    LONGERNAMESPANNINGBLOCKS_2);
+
+std::ostream& operator<<(std::ostream& os, CaseCollision value) {
+    return os << "CaseCollision(" << int(value) << ")";
+}
+
+// Dense enum with gaps and an alias
+nav_declare_enum(Gaps, int, A = -2, B = 0, C, Alias = B, D = 5);
+
+// Sparse enum made of a few clusters of values, with some outliers
+nav_declare_enum(
+    Status,
+    short,
+    Refused = -10,
+    Reset,
+    Aborted,
+    TimedOut,
+    Error = -1,
+    Continue = 100,
+    SwitchingProtocols,
+    Processing,
+    EarlyHints,
+    Ok = 200,
+    Created,
+    Accepted,
+    NonAuthoritative,
+    NoContent,
+    ResetContent,
+    PartialContent,
+    Success = Ok,
+    ImUsed = 226,
+    BadRequest = 400,
+    Unauthorized,
+    PaymentRequired,
+    Forbidden,
+    NotFound,
+    Conflict = 409,
+    Gone,
+    LengthRequired,
+    InternalError = 500,
+    NotImplemented,
+    BadGateway,
+    ServiceUnavailable,
+    GatewayTimeout,
+    LoopDetected = 508,
+    NetworkAuthRequired = 511);
+
+// Scattered values spanning the full range of the underlying type
+nav_declare_enum(
+    Magic,
+    uint64_t,
+    Zero = 0,
+    Elf = 0x7f454c46,
+    Png = 0x89504e470d0a1a0a,
+    Deadbeef = 0xdeadbeef,
+    Cafebabe = 0xcafebabe00000000,
+    HighBit = 0x8000000000000000,
+    Max = 0xffffffffffffffff,
+    AlsoMax = Max);
 
 #include <catch2/catch_test_macros.hpp>
 
@@ -178,3 +248,237 @@ TEST_CASE("Test name lookup", "[sparse-enum][fib][name-lookup]") {
         REQUIRE(traits::names_to_values[traits::names[i]] == traits::values[i]);
     }
 }
+
+TEST_CASE("Test perfect hash lookup", "[sparse-enum][fib][name-lookup]") {
+    using traits = nav::enum_traits<FooBar::FibonacciNumbers>;
+
+    for (size_t i = 0; i < traits::size; i++) {
+        INFO(fmt::format("i = {}, traits::names[i] = {}", i, traits::names[i]));
+        REQUIRE(traits::get_value(traits::names[i]) == traits::values[i]);
+    }
+    REQUIRE(traits::get_value("") == std::nullopt);
+    REQUIRE(traits::get_value("F") == std::nullopt);
+    REQUIRE(traits::get_value("F93") == std::nullopt);
+    REQUIRE(traits::get_value("f10") == std::nullopt);
+    REQUIRE(
+        traits::get_value("F100", FooBar::FibonacciNumbers::F0)
+        == FooBar::FibonacciNumbers::F0);
+}
+
+TEST_CASE("Test lookup ignoring case", "[sparse-enum][fib][name-lookup]") {
+    using traits = nav::enum_traits<FooBar::FibonacciNumbers>;
+    using FooBar::FibonacciNumbers;
+
+    for (size_t i = 0; i < traits::size; i++) {
+        std::string lower = fmt::format("f{}", i);
+        INFO(fmt::format("i = {}, lower = {}", i, lower));
+        REQUIRE(traits::get_value_ignore_case(lower) == traits::values[i]);
+        REQUIRE(
+            traits::get_value_ignore_case(traits::names[i])
+            == traits::values[i]);
+    }
+    REQUIRE(traits::get_value_ignore_case("") == std::nullopt);
+    REQUIRE(traits::get_value_ignore_case("f") == std::nullopt);
+    REQUIRE(traits::get_value_ignore_case("f93") == std::nullopt);
+    REQUIRE(
+        traits::get_value_ignore_case("f100", FibonacciNumbers::F0)
+        == FibonacciNumbers::F0);
+    REQUIRE(
+        traits::get_value_ignore_case("f12", FibonacciNumbers::F0)
+        == FibonacciNumbers::F12);
+
+    using collision_traits = nav::enum_traits<CaseCollision>;
+    // Keys which sort before every name
+    REQUIRE(collision_traits::get_value("") == std::nullopt);
+    REQUIRE(collision_traits::get_value("A") == std::nullopt);
+    REQUIRE(
+        collision_traits::get_value_ignore_case("vAlUe")
+        == CaseCollision::Value);
+    REQUIRE(
+        collision_traits::get_value_ignore_case("value")
+        == CaseCollision::Value);
+    REQUIRE(
+        collision_traits::get_value_ignore_case("OTHERVALUE")
+        == CaseCollision::OtherValue);
+    REQUIRE(
+        collision_traits::get_value_ignore_case("longerNameSpanningBlocks")
+        == CaseCollision::LongerNameSpanningBlocks);
+    REQUIRE(
+        collision_traits::get_value_ignore_case("longernamespanningblocks_2")
+        == CaseCollision::LONGERNAMESPANNINGBLOCKS_2);
+    // Only ASCII letters are folded. These differ from a name by 0x20 in the
+    // position of the '_', and by 0x80 in the position of the 'S'
+    std::string_view not_underscore = "longernamespanningblocks\x7f"
+                                      "2";
+    std::string_view not_s = "LongerName\xd3panningBlocks";
+    REQUIRE(
+        collision_traits::get_value_ignore_case(not_underscore)
+        == std::nullopt);
+    REQUIRE(collision_traits::get_value_ignore_case(not_s) == std::nullopt);
+}
+
+TEST_CASE("Test ASCII case folding", "[name-lookup]") {
+    // Check every byte, in every position of the block, with bytes on either
+    // side that could carry into it
+    for (int ch = 0; ch < 256; ch++) {
+        char expected = nav::detail::to_lower(char(ch));
+        for (int pos = 0; pos < 8; pos++) {
+            for (uint64_t fill : {uint64_t(0), ~uint64_t(0)}) {
+                uint64_t byte_mask = uint64_t(0xff) << (8 * pos);
+                uint64_t block = (fill & ~byte_mask)
+                               | uint64_t(ch) << (8 * pos);
+                uint64_t lower = nav::detail::ascii_to_lower_block(block);
+                REQUIRE(char(lower >> (8 * pos)) == expected);
+                REQUIRE((lower & ~byte_mask) == (block & ~byte_mask));
+            }
+        }
+    }
+    REQUIRE(nav::detail::equal_ignore_case("HELLO, World!", "hello, wORLD!"));
+    REQUIRE_FALSE(nav::detail::equal_ignore_case("Hello@", "hello`"));
+    REQUIRE_FALSE(nav::detail::equal_ignore_case("Hello", "Hello "));
+}
+
+// Hashes of every prefix of a 256 byte string, computed at compile time
+struct prefix_hashes {
+    char source[256] {};
+    uint64_t hashes[257] {};
+    uint64_t ignore_case_hashes[257] {};
+
+    constexpr prefix_hashes() {
+        uint64_t state = 0x853c49e6748fea9b;
+        for (char& ch : source) {
+            state = state * 6364136223846793005 + 1442695040888963407;
+            ch = char(state >> 56);
+        }
+        for (size_t size = 0; size <= 256; size++) {
+            std::string_view sv(source, size);
+            hashes[size] = nav::detail::block8_hash_seeded(sv, 7);
+            ignore_case_hashes[size] =
+                nav::detail::block8_hash_ignore_case_seeded(sv, 7);
+        }
+    }
+};
+
+TEST_CASE("Hashes are the same at compile time and run time", "[name-lookup]") {
+    constexpr prefix_hashes expected {};
+    // Hash copies at every offset, so that loads are unaligned
+    char buffer[256 + 8] {};
+    for (size_t offset = 0; offset < 8; offset++) {
+        std::copy(expected.source, expected.source + 256, buffer + offset);
+        for (size_t size = 0; size <= 256; size++) {
+            std::string_view sv(buffer + offset, size);
+            REQUIRE(
+                nav::detail::block8_hash_seeded(sv, 7) == expected.hashes[size]);
+            REQUIRE(
+                nav::detail::block8_hash_ignore_case_seeded(sv, 7)
+                == expected.ignore_case_hashes[size]);
+            REQUIRE(expected.hashes[size] < nav::detail::mersenne_61);
+        }
+    }
+}
+
+TEST_CASE("Test dense value to name lookup", "[dense-enum][value-lookup]") {
+    using traits = nav::enum_traits<Gaps>;
+    REQUIRE(traits::get_name(Gaps::A) == "A");
+    REQUIRE(traits::get_name(Gaps::B) == "B");
+    REQUIRE(traits::get_name(Gaps::C) == "C");
+    REQUIRE(traits::get_name(Gaps::D) == "D");
+    // Aliases get the name declared first
+    REQUIRE(traits::get_name(Gaps::Alias) == "B");
+    for (int gap : {-3, -1, 2, 3, 4, 6}) {
+        INFO("gap = " << gap);
+        REQUIRE(traits::get_name(Gaps(gap)) == std::nullopt);
+        REQUIRE(traits::get_name(Gaps(gap), "<unnamed>") == "<unnamed>");
+    }
+
+    // Every value in [min, max] has a name
+    using collision_traits = nav::enum_traits<CaseCollision>;
+    for (size_t i = 0; i < collision_traits::size; i++) {
+        REQUIRE(
+            collision_traits::get_name(collision_traits::values[i])
+            == collision_traits::names[i]);
+    }
+    REQUIRE(collision_traits::get_name(CaseCollision(-1)) == std::nullopt);
+    REQUIRE(collision_traits::get_name(CaseCollision(6)) == std::nullopt);
+
+    // One byte per slot, plus the bitset, rather than a string_view per slot
+    REQUIRE(sizeof(collision_traits::values_to_names) <= 32);
+}
+
+TEST_CASE("Test clustered value to name lookup", "[sparse-enum][value-lookup]") {
+    using traits = nav::enum_traits<Status>;
+    // Runs are -10..-7, 100..103, 200..206, 400..404, and 500..511. The
+    // outliers are -1, 226, 409, 410, and 411
+    constexpr auto layout = nav::detail::value_index<Status>::layout;
+    REQUIRE(layout.num_runs == 5);
+    REQUIRE(layout.num_slots == 4 + 4 + 7 + 5 + 12);
+    REQUIRE(layout.num_outliers == 5);
+
+    // Every value gets the first name declared for it, and values without a
+    // name (including the gaps in a run) aren't found
+    for (int i = -300; i <= 800; i++) {
+        INFO("value = " << i);
+        auto value = Status(i);
+        std::optional<std::string_view> expected;
+        for (size_t j = traits::size; j-- > 0;) {
+            if (traits::values[j] == value) {
+                expected = traits::names[j];
+            }
+        }
+        REQUIRE(nav::name_of(value) == expected);
+        REQUIRE(traits::get_name(value) == expected);
+    }
+    REQUIRE(traits::get_name(Status::Success) == "Ok");
+    REQUIRE(traits::get_name(Status(507), "<unnamed>") == "<unnamed>");
+}
+
+TEST_CASE("Test perfect hash of integers", "[sparse-enum][value-lookup]") {
+    // Keys which only differ in their high bits, or only in their low bits
+    std::array<uint64_t, 100> keys {};
+    for (size_t i = 0; i < 50; i++) {
+        keys[i] = uint64_t(i) << 40;
+        keys[i + 50] = ~uint64_t(0) - i;
+    }
+    auto hash = nav::detail::multiply_shift_hash<100>(keys);
+    REQUIRE(hash.table_size == 128);
+    std::array<bool, 128> used {};
+    for (uint64_t key : keys) {
+        size_t slot = hash.slot_of(key);
+        REQUIRE(slot < hash.table_size);
+        REQUIRE_FALSE(used[slot]);
+        used[slot] = true;
+    }
+}
+
+TEST_CASE("Test scattered value to name lookup", "[sparse-enum][value-lookup]") {
+    using traits = nav::enum_traits<Magic>;
+    REQUIRE(nav::detail::value_index<Magic>::layout.num_runs == 0);
+    for (size_t i = 0; i < traits::size; i++) {
+        Magic value = traits::values[i];
+        std::string_view expected = value == Magic::Max ? "Max"
+                                                        : traits::names[i];
+        REQUIRE(nav::name_of(value) == expected);
+        REQUIRE(traits::get_name(value) == expected);
+        for (uint64_t delta : {uint64_t(1), uint64_t(1) << 32, ~uint64_t(0)}) {
+            Magic other = Magic(uint64_t(value) + delta);
+            if (other != Magic::Zero && other != Magic::Max) {
+                REQUIRE(nav::name_of(other) == std::nullopt);
+                REQUIRE(traits::get_name(other) == std::nullopt);
+            }
+        }
+    }
+
+    using fib_traits = nav::enum_traits<FooBar::FibonacciNumbers>;
+    for (size_t i = 0; i < fib_traits::size; i++) {
+        // F1 and F2 are both 1
+        size_t expected = i == 2 ? 1 : i;
+        REQUIRE(
+            nav::name_of(fib_traits::values[i])
+            == fib_traits::names[expected]);
+        // Fibonacci numbers are never negative
+        REQUIRE(
+            nav::name_of(FooBar::FibonacciNumbers(
+                -int64_t(fib_traits::values[i]) - 1))
+            == std::nullopt);
+    }
+}